@@ -0,0 +1,778 @@
+// Batch front end of the software rasterizer: renders every frame of a camera path into an image file, as fast as it can
+// No window, no DirectX and no SDL, builds wherever the SoftwareRasterizer library builds (see CMakeLists.txt)
+#include "BatchScene.h"
+#include "Camera.h"
+#include "ImageIO.h"
+#include "JobSystem.h"
+#include "Profiler.h"
+#include "SoftwareRasterizer.h"
+#include "ThroughputRasterizer.h"
+#include "VideoStream.h"
+#ifdef DAE_HAS_PROCESSES
+#include "DistributedRenderer.h"
+#endif
+#ifdef DAE_HAS_SHARED_FRAMES
+#include "SharedFrameRing.h"
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <filesystem>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+using namespace dae;
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	double GetMilliseconds(Clock::time_point start, Clock::time_point end)
+	{
+		return std::chrono::duration<double, std::milli>(end - start).count();
+	}
+
+	struct BatchSettings
+	{
+		std::string ScenePath{ "Resources/vehicle.scene" };
+		std::string CameraPathPath{};
+		std::string OutputDirectory{};  // Empty: no image files (only the shared memory ring or the video stream)
+		int Width{ 640 };
+		int Height{ 480 };
+		float FovAngle{ 45.0f };
+		ImageIO::FileFormat Format{ ImageIO::FileFormat::PNG };
+		int NumEncoders{ 0 };  // 0: encode on the render thread
+		bool PrintFrameTimings{ true };
+		JobSystemSettings JobSystem{};
+		SoftwareRenderSettings Render{};
+
+		// Throughput mode: several frames at once instead of all threads on one frame
+		bool UseThroughputMode{ false };
+		ThroughputSettings Throughput{};
+
+		// Distributed mode: every frame split over worker processes, 0 = render in this process
+		int NumProcesses{ 0 };
+#ifdef DAE_HAS_PROCESSES
+		DistributedSettings Distributed{};
+#endif
+
+		// Shared memory frame ring for other processes, empty name = none
+		std::string SharedFramesName{};
+		uint32_t NumSharedFrameSlots{ 4 };
+		bool ShareDepth{ false };
+#ifdef DAE_HAS_SHARED_FRAMES
+		SharedFramePolicy SharedFramesPolicy{ SharedFramePolicy::Overwrite };
+#endif
+
+		// Live video for an encoder, empty path = none, "-" = stdout
+		std::string StreamPath{};
+		VideoStream::Format StreamFormat{ VideoStream::Format::Y4M };
+		int StreamFramesPerSecond{ 30 };
+
+		// Chrome trace of the stage markers, empty path = none (needs a DAE_PROFILING build)
+		std::string TracePath{};
+
+		// Pipeline statistics of every frame (latency mode)
+		bool PrintStatistics{ false };
+	};
+
+	struct FrameTiming
+	{
+		double renderMs{};
+		double encodeMs{};
+		SoftwarePipelineStatistics statistics{};
+	};
+
+	// Rendered frame on its way to the file
+	struct EncodeJob
+	{
+		std::vector<uint32_t>* pPixels{ nullptr };
+		uint32_t frameIndex{};
+	};
+
+	// Writes the frames on threads of their own, rendering goes on in the other buffers meanwhile
+	// Without encoder threads Submit writes the frame itself
+	class FrameEncoder final
+	{
+	public:
+		FrameEncoder(const BatchSettings& settings, std::vector<FrameTiming>& timings) :
+			m_Settings{ settings },
+			m_Timings{ timings }
+		{
+			// 2 buffers per encoder keeps every encoder busy while the next frame renders
+			const size_t numBuffers{ size_t(std::max(1, settings.NumEncoders * 2)) };
+			m_Buffers.resize(numBuffers);
+			for(std::vector<uint32_t>& buffer : m_Buffers)
+			{
+				buffer.resize(size_t(settings.Width) * settings.Height);
+				m_FreeBuffers.push_back(&buffer);
+			}
+
+			for(int i{ 0 }; i < settings.NumEncoders; ++i)
+				m_Threads.emplace_back(&FrameEncoder::EncodeLoop, this);
+		}
+
+		~FrameEncoder()
+		{
+			{
+				std::lock_guard<std::mutex> lock{ m_Mutex };
+				m_IsStopping = true;
+			}
+			m_Condition.notify_all();
+
+			for(std::thread& thread : m_Threads)
+				thread.join();
+		}
+
+		FrameEncoder(const FrameEncoder&) = delete;
+		FrameEncoder& operator=(const FrameEncoder&) = delete;
+		FrameEncoder(FrameEncoder&&) = delete;
+		FrameEncoder& operator=(FrameEncoder&&) = delete;
+
+		// Waits until an encoder gave one back
+		std::vector<uint32_t>* AcquireBuffer()
+		{
+			std::unique_lock<std::mutex> lock{ m_Mutex };
+			m_Condition.wait(lock, [this]() { return !m_FreeBuffers.empty(); });
+
+			std::vector<uint32_t>* pBuffer{ m_FreeBuffers.front() };
+			m_FreeBuffers.pop_front();
+			return pBuffer;
+		}
+
+		// Gives a buffer back without writing it (nothing was rendered into it)
+		void ReleaseBuffer(std::vector<uint32_t>* pBuffer)
+		{
+			{
+				std::lock_guard<std::mutex> lock{ m_Mutex };
+				m_FreeBuffers.push_back(pBuffer);
+			}
+			m_Condition.notify_all();
+		}
+
+		void Submit(std::vector<uint32_t>* pPixels, uint32_t frameIndex)
+		{
+			// No files, the frames only went to the shared memory ring
+			if(m_Settings.OutputDirectory.empty())
+			{
+				ReleaseBuffer(pPixels);
+				return;
+			}
+
+			if(m_Threads.empty())
+			{
+				Write(pPixels->data(), frameIndex);
+				ReleaseBuffer(pPixels);
+				return;
+			}
+
+			{
+				std::lock_guard<std::mutex> lock{ m_Mutex };
+				m_Jobs.push_back({ pPixels, frameIndex });
+			}
+			m_Condition.notify_all();
+		}
+
+		// Waits until every submitted frame is written
+		void Flush()
+		{
+			std::unique_lock<std::mutex> lock{ m_Mutex };
+			m_Condition.wait(lock, [this]() { return m_FreeBuffers.size() == m_Buffers.size(); });
+		}
+
+		// Writes the frame right away on the calling thread, any thread can call this
+		void Write(const uint32_t* pPixels, uint32_t frameIndex)
+		{
+			char fileName[32]{};
+			std::snprintf(fileName, sizeof(fileName), "frame_%05u%s", frameIndex, ImageIO::GetExtension(m_Settings.Format));
+			const std::string path{ (std::filesystem::path{ m_Settings.OutputDirectory } / fileName).string() };
+
+			DAE_PROFILE_SCOPE("Encode");
+			const Clock::time_point start{ Clock::now() };
+			if(!ImageIO::SaveImage(path, m_Settings.Format, pPixels, m_Settings.Width, m_Settings.Height, m_Settings.Width))
+			{
+				std::cout << "BatchRender: could not write " << path << "\n";
+				++m_NumFailed;
+			}
+			m_Timings[frameIndex].encodeMs = GetMilliseconds(start, Clock::now());
+		}
+
+		bool HasThreads() const { return !m_Threads.empty(); };
+		uint32_t GetNumFailed() const { return m_NumFailed; };
+
+	private:
+		const BatchSettings& m_Settings;
+		std::vector<FrameTiming>& m_Timings;  // Every frame index is only written by the thread encoding it
+
+		std::vector<std::vector<uint32_t>> m_Buffers{};
+		std::deque<std::vector<uint32_t>*> m_FreeBuffers{};
+		std::deque<EncodeJob> m_Jobs{};
+		std::atomic<uint32_t> m_NumFailed{ 0 };
+
+		std::vector<std::thread> m_Threads{};
+		std::mutex m_Mutex{};
+		std::condition_variable m_Condition{};  // Free buffers, jobs and stopping all share it, there are only a handful of threads
+		bool m_IsStopping{ false };
+
+		void EncodeLoop()
+		{
+			DAE_PROFILE_THREAD("Encoder");
+			while(true)
+			{
+				EncodeJob job{};
+				{
+					std::unique_lock<std::mutex> lock{ m_Mutex };
+					m_Condition.wait(lock, [this]() { return m_IsStopping || !m_Jobs.empty(); });
+					if(m_Jobs.empty())
+						return;
+
+					job = m_Jobs.front();
+					m_Jobs.pop_front();
+				}
+
+				Write(job.pPixels->data(), job.frameIndex);
+				ReleaseBuffer(job.pPixels);
+			}
+		}
+	};
+
+	void PrintUsage()
+	{
+		std::cout <<
+			"Usage: BatchRender -camerapath <file> -output <directory> [options]\n"
+			"       BatchRender -camerapath <file> -shm <name> [options]\n"
+			"       BatchRender -camerapath <file> -stream <pipe|-> [options]\n"
+			"    -scene <file>         Meshes + textures (default Resources/vehicle.scene)\n"
+			"    -width <pixels>       Default 640\n"
+			"    -height <pixels>      Default 480\n"
+			"    -fov <degrees>        Default 45\n"
+			"    -format <png|ppm>     Default png\n"
+			"    -encoders <count>     Threads writing the images, 0 writes them on the render thread (default)\n"
+			"    -workers <count>      Rasterizer worker threads (default: one per core - 1)\n"
+			"    -pin                  Pin the workers to their own core\n"
+			"    -pipelined            Overlap the geometry of the next frame with the raster of this one\n"
+			"    -srgb                 Encode the output to sRGB\n"
+			"    -throughput           Render several frames at once, every frame on its own threads (-pin pins them)\n"
+			"    -slots <count>        Frames at once in throughput mode (default: as many as fit on the cores)\n"
+			"    -slotworkers <count>  Workers per frame in throughput mode on top of its own thread (default 0)\n"
+			"    -processes <count>    Split every frame in bands rendered by that many worker processes (Linux)\n"
+			"    -processworkers <count> Workers per process on top of its own thread (default: the cores split over the processes)\n"
+			"    -processtimeout <ms>  Kill a worker process that takes longer on one band, its band renders on another one (default 5000)\n"
+			"    -nobalance            Equal bands for every process instead of larger bands for the faster ones\n"
+			"    -shm <name>           Also publish every frame in a shared memory ring (\"/name\", POSIX), for other processes to read\n"
+			"    -shmslots <count>     Frames in the ring (default 4)\n"
+			"    -shmdepth             Put the depth buffer of every frame in the ring too\n"
+			"    -shmdrop              Drop new frames while the reader didn't release the oldest ones, instead of overwriting them\n"
+			"    -stream <path|->      Also stream the frames as uncompressed video to a (named) pipe, - = stdout (messages go to stderr)\n"
+			"    -streamformat <y4m|rgba> Default y4m (YUV 4:2:0), rgba is raw 4 bytes per pixel\n"
+			"    -fps <count>          Frame rate in the y4m header (default 30)\n"
+			"    -trace <file>         Write the stage markers as Chrome trace JSON (chrome://tracing), needs a DAE_PROFILING build\n"
+			"    -stats                Print the pipeline statistics: culled triangles, tested and shaded pixels, overdraw (not with -throughput or -processes)\n"
+			"    -quiet                Only print the summary, not the timing of every frame\n";
+	}
+
+	bool ParseArguments(int argc, char* args[], BatchSettings& settings)
+	{
+		for(int i{ 1 }; i < argc; ++i)
+		{
+			const std::string argument{ args[i] };
+			const bool hasValue{ i + 1 < argc };
+			if(argument == "-scene" && hasValue)
+				settings.ScenePath = args[++i];
+			else if(argument == "-camerapath" && hasValue)
+				settings.CameraPathPath = args[++i];
+			else if(argument == "-output" && hasValue)
+				settings.OutputDirectory = args[++i];
+			else if(argument == "-width" && hasValue)
+				settings.Width = std::atoi(args[++i]);
+			else if(argument == "-height" && hasValue)
+				settings.Height = std::atoi(args[++i]);
+			else if(argument == "-fov" && hasValue)
+				settings.FovAngle = float(std::atof(args[++i]));
+			else if(argument == "-format" && hasValue)
+			{
+				const std::string format{ args[++i] };
+				if(format == "png")
+					settings.Format = ImageIO::FileFormat::PNG;
+				else if(format == "ppm")
+					settings.Format = ImageIO::FileFormat::PPM;
+				else
+					return false;
+			}
+			else if(argument == "-encoders" && hasValue)
+				settings.NumEncoders = std::max(0, std::atoi(args[++i]));
+			else if(argument == "-workers" && hasValue)
+				settings.JobSystem.NumWorkers = std::atoi(args[++i]);
+			else if(argument == "-pin")
+			{
+				settings.JobSystem.PinWorkers = true;
+				settings.Throughput.PinThreads = true;
+#ifdef DAE_HAS_PROCESSES
+				settings.Distributed.PinThreads = true;
+#endif
+			}
+			else if(argument == "-pipelined")
+				settings.Render.PipelinedFrames = true;
+			else if(argument == "-srgb")
+				settings.Render.SRGBOutput = true;
+			else if(argument == "-throughput")
+				settings.UseThroughputMode = true;
+			else if(argument == "-slots" && hasValue)
+				settings.Throughput.NumSlots = std::atoi(args[++i]);
+			else if(argument == "-slotworkers" && hasValue)
+				settings.Throughput.WorkersPerSlot = std::max(0, std::atoi(args[++i]));
+			else if(argument == "-processes" && hasValue)
+				settings.NumProcesses = std::max(0, std::atoi(args[++i]));
+#ifdef DAE_HAS_PROCESSES
+			else if(argument == "-processworkers" && hasValue)
+				settings.Distributed.WorkersPerProcess = std::atoi(args[++i]);
+			else if(argument == "-processtimeout" && hasValue)
+				settings.Distributed.TimeoutMs = std::max(1, std::atoi(args[++i]));
+			else if(argument == "-nobalance")
+				settings.Distributed.Balance = false;
+#endif
+			else if(argument == "-shm" && hasValue)
+				settings.SharedFramesName = args[++i];
+			else if(argument == "-shmslots" && hasValue)
+				settings.NumSharedFrameSlots = uint32_t(std::max(1, std::atoi(args[++i])));
+			else if(argument == "-shmdepth")
+				settings.ShareDepth = true;
+#ifdef DAE_HAS_SHARED_FRAMES
+			else if(argument == "-shmdrop")
+				settings.SharedFramesPolicy = SharedFramePolicy::Drop;
+#endif
+			else if(argument == "-stream" && hasValue)
+				settings.StreamPath = args[++i];
+			else if(argument == "-streamformat" && hasValue)
+			{
+				const std::string format{ args[++i] };
+				if(format == "y4m")
+					settings.StreamFormat = VideoStream::Format::Y4M;
+				else if(format == "rgba")
+					settings.StreamFormat = VideoStream::Format::RGBA;
+				else
+					return false;
+			}
+			else if(argument == "-fps" && hasValue)
+				settings.StreamFramesPerSecond = std::max(1, std::atoi(args[++i]));
+			else if(argument == "-trace" && hasValue)
+				settings.TracePath = args[++i];
+			else if(argument == "-stats")
+				settings.PrintStatistics = true;
+			else if(argument == "-quiet")
+				settings.PrintFrameTimings = false;
+			else
+				return false;
+		}
+
+		// The ring and the stream only get the frames of the latency mode, the other modes finish them out of order
+		const bool hasSharedFrames{ !settings.SharedFramesName.empty() };
+		const bool hasStream{ !settings.StreamPath.empty() };
+		if((hasSharedFrames || hasStream || settings.PrintStatistics) && (settings.UseThroughputMode || settings.NumProcesses > 0))
+			return false;
+
+		return !settings.CameraPathPath.empty() && (!settings.OutputDirectory.empty() || hasSharedFrames || hasStream) &&
+			settings.Width > 0 && settings.Height > 0 && settings.FovAngle > 0.0f;
+	}
+
+	void PrintTimings(const std::vector<FrameTiming>& timings, double totalMs, bool printFrames)
+	{
+		if(printFrames)
+		{
+			for(size_t i{ 0 }; i < timings.size(); ++i)
+				std::printf("frame %5zu: render %8.3f ms, encode %8.3f ms\n", i, timings[i].renderMs, timings[i].encodeMs);
+		}
+
+		double renderMin{ timings.front().renderMs };
+		double renderMax{ timings.front().renderMs };
+		double renderSum{}, encodeSum{};
+		for(const FrameTiming& timing : timings)
+		{
+			renderMin = std::min(renderMin, timing.renderMs);
+			renderMax = std::max(renderMax, timing.renderMs);
+			renderSum += timing.renderMs;
+			encodeSum += timing.encodeMs;
+		}
+
+		const double numFrames{ double(timings.size()) };
+		std::printf("%zu frames in %.3f s: %.2f fps\n", timings.size(), totalMs / 1000.0, numFrames * 1000.0 / totalMs);
+		std::printf("render: avg %.3f ms, min %.3f ms, max %.3f ms\n", renderSum / numFrames, renderMin, renderMax);
+		std::printf("encode: avg %.3f ms\n", encodeSum / numFrames);
+	}
+
+	void PrintStatistics(const std::vector<FrameTiming>& timings, bool printFrames)
+	{
+		SoftwarePipelineStatistics total{};
+		for(size_t i{ 0 }; i < timings.size(); ++i)
+		{
+			const SoftwarePipelineStatistics& statistics{ timings[i].statistics };
+			total.Add(statistics);
+			if(printFrames)
+			{
+				std::printf("frame %5zu: %llu of %llu triangles binned, %llu pixels shaded, overdraw %.2f\n", i,
+					(unsigned long long)statistics.trianglesBinned, (unsigned long long)statistics.trianglesSubmitted,
+					(unsigned long long)statistics.pixelsPassed, statistics.GetOverdraw());
+			}
+		}
+
+		// Averages per frame, the percentages are of the triangles submitted
+		const double numFrames{ double(timings.size()) };
+		const double numSubmitted{ std::max(double(total.trianglesSubmitted), 1.0) };
+		const auto printTriangles{ [&](const char* name, uint64_t count)
+		{
+			std::printf("  %-22s %12.0f (%5.1f%%)\n", name, double(count) / numFrames, 100.0 * double(count) / numSubmitted);
+		} };
+		const auto printCount{ [&](const char* name, uint64_t count)
+		{
+			std::printf("  %-22s %12.0f\n", name, double(count) / numFrames);
+		} };
+
+		std::printf("pipeline statistics, average per frame:\n");
+		printCount("vertices transformed", total.verticesTransformed);
+		printCount("triangles submitted", total.trianglesSubmitted);
+		printTriangles("degenerate", total.trianglesDegenerate);
+		printTriangles("near / far culled", total.trianglesDepthCulled);
+		printTriangles("frustum culled", total.trianglesFrustumCulled);
+		printTriangles("outside band", total.trianglesOutsideBand);
+		printTriangles("binned", total.trianglesBinned);
+		printCount("triangle tiles", total.triangleTilesRasterized);
+		printCount("  without pixels", total.triangleTilesEmpty);
+		printCount("pixels tested", total.pixelsTested);
+		printCount("pixels passed", total.pixelsPassed);
+		printCount("pixel shader calls", total.pixelShaderInvocations);
+		printCount("pixels drawn", total.pixelsDrawn);
+		std::printf("  %-22s %11.1f%%\n", "screen covered", 100.0 * double(total.pixelsDrawn) / double(std::max(total.numPixels, uint64_t(1))));
+		std::printf("  %-22s %12.2f\n", "overdraw", total.GetOverdraw());
+		if(total.pixelShaderInvocations > 0)
+			std::printf("  %-22s %11.1f%%\n", "pixel shader lanes used", 100.0 * double(total.pixelsPassed) / double(4 * total.pixelShaderInvocations));
+	}
+
+	// One frame at a time, all threads work on it
+	uint32_t RenderLatency(const BatchSettings& settings, const BatchScene& scene, const std::vector<CameraPathFrame>& cameraPath, std::vector<FrameTiming>& timings)
+	{
+		JobSystem jobSystem{ settings.JobSystem };
+		SoftwareRasterizer rasterizer{ settings.Width, settings.Height, jobSystem, {}, ImageIO::GetRGBAPacking() };
+		Camera camera{ {}, settings.FovAngle, 1.0f, 100.0f, settings.Width / float(settings.Height) };
+		const uint32_t numFrames{ uint32_t(cameraPath.size()) };
+
+		// First, streaming to stdout sends all of the messages to stderr
+		VideoStream* pStream{ nullptr };
+		if(!settings.StreamPath.empty())
+		{
+			pStream = VideoStream::Open(settings.StreamPath, settings.StreamFormat, settings.Width, settings.Height, settings.StreamFramesPerSecond);
+			if(!pStream)
+				return numFrames;
+		}
+		const bool isStreamingRGBA{ pStream && pStream->GetFormat() == VideoStream::Format::RGBA };
+
+		std::cout << "BatchRender: " << numFrames << " frames at " << settings.Width << "x" << settings.Height
+			<< ", " << jobSystem.GetNumWorkers() << " workers + main thread, " << settings.NumEncoders << " encoders\n";
+
+#ifdef DAE_HAS_SHARED_FRAMES
+		SharedFrameWriter* pSharedFrames{ nullptr };
+		if(!settings.SharedFramesName.empty())
+		{
+			pSharedFrames = SharedFrameWriter::Create(settings.SharedFramesName, settings.Width, settings.Height, settings.NumSharedFrameSlots,
+				settings.ShareDepth, settings.SharedFramesPolicy, ImageIO::GetRGBAPacking());
+			if(!pSharedFrames)
+			{
+				delete pStream;
+				return numFrames;
+			}
+		}
+#endif
+
+		FrameEncoder encoder{ settings, timings };
+		SoftwareScene softwareScene{};
+
+		// Pipelined, every call shows the frame of the call before, one extra call at the end shows the last one
+		const uint32_t frameLatency{ settings.Render.PipelinedFrames ? 1u : 0u };
+		for(uint32_t callIndex{ 0 }; callIndex < numFrames + frameLatency; ++callIndex)
+		{
+			const CameraPathFrame& cameraFrame{ cameraPath[std::min(callIndex, numFrames - 1)] };
+			camera.SetView(cameraFrame.origin, cameraFrame.pitch, cameraFrame.yaw);
+			scene.FillScene(camera, softwareScene);
+
+			std::vector<uint32_t>* pPixels{ encoder.AcquireBuffer() };
+			uint32_t* pTarget{ pPixels->data() };
+
+#ifdef DAE_HAS_SHARED_FRAMES
+			// Rendered straight into its slot of the ring when there is one free
+			SharedFrameWriter::Frame sharedFrame{};
+			const bool isShared{ pSharedFrames && pSharedFrames->BeginFrame(sharedFrame) };
+			if(isShared)
+				pTarget = sharedFrame.pColor;
+#endif
+
+			// Y4M gets converted by the tile jobs, RGBA is the target itself when nothing else needs the pixels
+			VideoStream::Frame* pStreamFrame{ pStream ? pStream->AcquireFrame() : nullptr };
+			const bool needsPixels{ !settings.OutputDirectory.empty() || pTarget != pPixels->data() };
+			if(isStreamingRGBA && !needsPixels)
+				pTarget = pStreamFrame->pPixels;
+			else if(!isStreamingRGBA && !needsPixels)
+				pTarget = nullptr;
+			const YUVTarget* pYUVTarget{ pStream && !isStreamingRGBA ? &pStreamFrame->yuv : nullptr };
+
+			const Clock::time_point renderStart{ Clock::now() };
+			const bool hasFrame{ rasterizer.Render(softwareScene, settings.Render, pTarget, settings.Width, pYUVTarget) };
+			const double renderMs{ GetMilliseconds(renderStart, Clock::now()) };
+
+			if(pStreamFrame && !hasFrame)
+			{
+				pStream->ReleaseFrame(pStreamFrame);
+			}
+			else if(pStreamFrame)
+			{
+				if(isStreamingRGBA && pTarget != pStreamFrame->pPixels)
+					std::copy_n(pTarget, size_t(settings.Width) * settings.Height, pStreamFrame->pPixels);
+				pStream->Submit(pStreamFrame);
+			}
+
+			const uint32_t frameIndex{ callIndex - frameLatency };
+#ifdef DAE_HAS_SHARED_FRAMES
+			if(isShared && !hasFrame)
+			{
+				pSharedFrames->CancelFrame();
+			}
+			else if(isShared)
+			{
+				if(sharedFrame.pDepth)
+					rasterizer.CopyDepth(sharedFrame.pDepth, settings.Width);
+				pSharedFrames->EndFrame(frameIndex);
+
+				if(!settings.OutputDirectory.empty())
+					std::copy_n(sharedFrame.pColor, pPixels->size(), pPixels->data());
+			}
+#endif
+
+			if(!hasFrame)
+			{
+				encoder.ReleaseBuffer(pPixels);
+				continue;
+			}
+
+			timings[frameIndex].renderMs = renderMs;
+			timings[frameIndex].statistics = rasterizer.GetStatistics();
+			encoder.Submit(pPixels, frameIndex);
+		}
+
+		encoder.Flush();
+
+		// Done with the meshes before they go
+		rasterizer.Wait();
+
+#ifdef DAE_HAS_SHARED_FRAMES
+		if(pSharedFrames)
+		{
+			std::cout << "BatchRender: " << pSharedFrames->GetNumPublished() << " frames published to " << settings.SharedFramesName
+				<< ", " << pSharedFrames->GetNumDropped() << " dropped\n";
+			delete pSharedFrames;
+		}
+#endif
+
+		uint32_t numFailed{ encoder.GetNumFailed() };
+		if(pStream)
+		{
+			pStream->Flush();
+			if(pStream->HasFailed())
+			{
+				std::cout << "BatchRender: the video stream stopped, " << settings.StreamPath << " was closed\n";
+				numFailed = std::max(numFailed, 1u);
+			}
+			delete pStream;
+		}
+		return numFailed;
+	}
+
+	// Many frames at once, every frame on its own slot of threads
+	uint32_t RenderThroughput(const BatchSettings& settings, const BatchScene& scene, const std::vector<CameraPathFrame>& cameraPath, std::vector<FrameTiming>& timings)
+	{
+		ThroughputRasterizer rasterizer{ settings.Width, settings.Height, settings.Throughput, {}, ImageIO::GetRGBAPacking() };
+
+		const uint32_t numFrames{ uint32_t(cameraPath.size()) };
+		std::cout << "BatchRender: " << numFrames << " frames at " << settings.Width << "x" << settings.Height
+			<< ", throughput mode: " << rasterizer.GetNumSlots() << " frames at once, " << rasterizer.GetNumThreads() << " threads, "
+			<< settings.NumEncoders << " encoders\n";
+
+		// A camera and render start time per slot, every slot thread only touches its own
+		std::vector<Camera*> cameraPtrs{};
+		for(uint32_t i{ 0 }; i < rasterizer.GetNumSlots(); ++i)
+			cameraPtrs.push_back(new Camera{ {}, settings.FovAngle, 1.0f, 100.0f, settings.Width / float(settings.Height) });
+		std::vector<Clock::time_point> renderStarts(rasterizer.GetNumSlots());
+
+		FrameEncoder encoder{ settings, timings };
+
+		const auto getScene = [&](uint32_t slotIndex, uint32_t frameIndex, SoftwareScene& softwareScene)
+		{
+			const CameraPathFrame& cameraFrame{ cameraPath[frameIndex] };
+			cameraPtrs[slotIndex]->SetView(cameraFrame.origin, cameraFrame.pitch, cameraFrame.yaw);
+			scene.FillScene(*cameraPtrs[slotIndex], softwareScene);
+			renderStarts[slotIndex] = Clock::now();
+		};
+		const auto onFrame = [&](uint32_t slotIndex, uint32_t frameIndex, const uint32_t* pPixels, int pitch)
+		{
+			timings[frameIndex].renderMs = GetMilliseconds(renderStarts[slotIndex], Clock::now());
+
+			// Without encoder threads every slot writes its own frames, that is already parallel
+			if(!encoder.HasThreads())
+			{
+				encoder.Write(pPixels, frameIndex);
+				return;
+			}
+
+			std::vector<uint32_t>* pBuffer{ encoder.AcquireBuffer() };
+			for(int y{ 0 }; y < settings.Height; ++y)
+				std::copy_n(pPixels + size_t(y) * pitch, settings.Width, pBuffer->data() + size_t(y) * settings.Width);
+			encoder.Submit(pBuffer, frameIndex);
+		};
+		rasterizer.RenderFrames(numFrames, settings.Render, getScene, onFrame);
+
+		encoder.Flush();
+
+		for(Camera* pCamera : cameraPtrs)
+			delete pCamera;
+		return encoder.GetNumFailed();
+	}
+
+#ifdef DAE_HAS_PROCESSES
+	// Every frame split in bands over worker processes, this process only composites and encodes
+	uint32_t RenderDistributed(const BatchSettings& settings, const BatchScene& scene, const std::vector<CameraPathFrame>& cameraPath, std::vector<FrameTiming>& timings)
+	{
+		const uint32_t numFrames{ uint32_t(cameraPath.size()) };
+
+		// Forks, so before the encoder starts its threads
+		DistributedSettings distributedSettings{ settings.Distributed };
+		distributedSettings.NumProcesses = settings.NumProcesses;
+		DistributedRenderer* pRenderer{ DistributedRenderer::Create(settings.Width, settings.Height, settings.FovAngle, scene, distributedSettings, ImageIO::GetRGBAPacking()) };
+		if(!pRenderer)
+			return numFrames;
+
+		std::cout << "BatchRender: " << numFrames << " frames at " << settings.Width << "x" << settings.Height
+			<< ", " << pRenderer->GetNumProcesses() << " processes with " << pRenderer->GetWorkersPerProcess() << " workers + main thread each, "
+			<< settings.NumEncoders << " encoders\n";
+
+		uint32_t numRendered{ 0 };
+		uint32_t numFailed{ 0 };
+		{
+			FrameEncoder encoder{ settings, timings };
+			for(; numRendered < numFrames; ++numRendered)
+			{
+				std::vector<uint32_t>* pPixels{ encoder.AcquireBuffer() };
+				const Clock::time_point renderStart{ Clock::now() };
+				if(!pRenderer->RenderFrame(cameraPath[numRendered], settings.Render, pPixels->data(), settings.Width))
+				{
+					encoder.ReleaseBuffer(pPixels);
+					break;
+				}
+				timings[numRendered].renderMs = GetMilliseconds(renderStart, Clock::now());
+				encoder.Submit(pPixels, numRendered);
+			}
+
+			encoder.Flush();
+			numFailed = encoder.GetNumFailed();
+		}
+
+		delete pRenderer;
+		return numFailed + numFrames - numRendered;
+	}
+#endif
+}
+
+int main(int argc, char* args[])
+{
+	DAE_PROFILE_THREAD("Main");
+
+	BatchSettings settings{};
+	if(!ParseArguments(argc, args, settings))
+	{
+		PrintUsage();
+		return 1;
+	}
+
+#ifndef DAE_HAS_SHARED_FRAMES
+	if(!settings.SharedFramesName.empty())
+	{
+		std::cout << "BatchRender: built without shared memory frames, -shm needs Linux\n";
+		return 1;
+	}
+#endif
+
+	if(!settings.TracePath.empty() && !Profiler::IsEnabled())
+	{
+		std::cout << "BatchRender: built without DAE_PROFILING, -trace has nothing to write\n";
+		return 1;
+	}
+
+	if(!ImageIO::IsSupported(settings.Format))
+	{
+		std::cout << "BatchRender: built without libpng, use -format ppm\n";
+		return 1;
+	}
+
+	std::vector<CameraPathFrame> cameraPath{};
+	if(!LoadCameraPath(settings.CameraPathPath, cameraPath))
+		return 1;
+	if(cameraPath.empty())
+	{
+		std::cout << "BatchRender: " << settings.CameraPathPath << " has no frames\n";
+		return 1;
+	}
+
+	BatchScene* pScene{ BatchScene::LoadFromFile(settings.ScenePath) };
+	if(!pScene)
+		return 1;
+
+	std::error_code error{};
+	if(!settings.OutputDirectory.empty())
+		std::filesystem::create_directories(settings.OutputDirectory, error);
+	if(error)
+	{
+		std::cout << "BatchRender: could not create " << settings.OutputDirectory << "\n";
+		delete pScene;
+		return 1;
+	}
+
+	const uint32_t numFrames{ uint32_t(cameraPath.size()) };
+	std::vector<FrameTiming> timings(numFrames);
+	uint32_t numFailed{ 0 };
+
+	const Clock::time_point batchStart{ Clock::now() };
+	if(settings.NumProcesses > 0)
+	{
+#ifdef DAE_HAS_PROCESSES
+		numFailed = RenderDistributed(settings, *pScene, cameraPath, timings);
+#else
+		std::cout << "BatchRender: built without worker process support, -processes needs Linux\n";
+		numFailed = numFrames;
+#endif
+	}
+	else if(settings.UseThroughputMode)
+		numFailed = RenderThroughput(settings, *pScene, cameraPath, timings);
+	else
+		numFailed = RenderLatency(settings, *pScene, cameraPath, timings);
+	const double batchMs{ GetMilliseconds(batchStart, Clock::now()) };
+
+	PrintTimings(timings, batchMs, settings.PrintFrameTimings);
+	if(settings.PrintStatistics)
+		PrintStatistics(timings, settings.PrintFrameTimings);
+
+	// Only the threads of this process, worker processes keep their markers
+	if(!settings.TracePath.empty() && !Profiler::WriteChromeTrace(settings.TracePath))
+		std::cout << "BatchRender: could not write " << settings.TracePath << "\n";
+
+	delete pScene;
+
+	if(numFailed > 0)
+	{
+		std::cout << "BatchRender: " << numFailed << " frames could not be rendered or written\n";
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,224 @@
+#include "BatchScene.h"
+#include "Camera.h"
+#include "ImageIO.h"
+#include "Mesh.h"
+#include "Texture.h"
+#include "Utils.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace
+{
+	// Strips the comment, false when nothing is left
+	bool GetStatement(std::string& line)
+	{
+		const size_t commentStart{ line.find('#') };
+		if(commentStart != std::string::npos)
+			line.erase(commentStart);
+
+		return line.find_first_not_of(" \t\r") != std::string::npos;
+	}
+
+	std::string GetDirectory(const std::string& path)
+	{
+		const size_t lastSeparator{ path.find_last_of("/\\") };
+		if(lastSeparator == std::string::npos)
+			return {};
+		return path.substr(0, lastSeparator + 1);
+	}
+}
+
+BatchScene::~BatchScene()
+{
+	for(Mesh* pMesh : m_MeshPtrs)
+		delete pMesh;
+	m_MeshPtrs.clear();
+
+	for(Texture* pTexture : m_TexturePtrs)
+		delete pTexture;
+	m_TexturePtrs.clear();
+}
+
+BatchScene* BatchScene::LoadFromFile(const std::string& path)
+{
+	std::ifstream file{ path };
+	if(!file)
+	{
+		std::cout << "BatchScene: could not open " << path << "\n";
+		return nullptr;
+	}
+
+	const std::string directory{ GetDirectory(path) };
+	BatchScene* pScene{ new BatchScene{} };
+
+	// Instances of the same model only get parsed once
+	std::vector<std::string> meshPaths{};
+	std::vector<std::vector<Vertex>> meshVertices{};
+	std::vector<std::vector<uint32_t>> meshIndices{};
+
+	std::string line{};
+	int lineNumber{ 0 };
+	while(std::getline(file, line))
+	{
+		++lineNumber;
+		if(!GetStatement(line))
+			continue;
+
+		std::istringstream statement{ line };
+		std::string command{};
+		statement >> command;
+
+		bool isValid{ true };
+		if(command == "mesh")
+		{
+			std::string meshPath{};
+			Vector3 position{};
+			statement >> meshPath;
+			if(!(statement >> position.x >> position.y >> position.z))
+				position = {};
+
+			const auto cached{ std::find(meshPaths.begin(), meshPaths.end(), meshPath) };
+			size_t cacheIndex{ size_t(cached - meshPaths.begin()) };
+			if(cached == meshPaths.end() && !meshPath.empty())
+			{
+				std::vector<Vertex> vertices{};
+				std::vector<uint32_t> indices{};
+				if(Utils::ParseOBJ(directory + meshPath, vertices, indices))
+				{
+					meshPaths.push_back(meshPath);
+					meshVertices.push_back(std::move(vertices));
+					meshIndices.push_back(std::move(indices));
+				}
+			}
+
+			isValid = cacheIndex < meshPaths.size();
+			if(isValid)
+				pScene->m_MeshPtrs.push_back(new Mesh{ meshVertices[cacheIndex], meshIndices[cacheIndex], position });
+		}
+		else if(command == "rotate")
+		{
+			float yaw{};
+			isValid = !pScene->m_MeshPtrs.empty() && static_cast<bool>(statement >> yaw);
+			if(isValid)
+				pScene->m_MeshPtrs.back()->RotateY(yaw * TO_RADIANS);
+		}
+		else if(command == "diffuse" || command == "normal" || command == "specular" || command == "gloss")
+		{
+			std::string texturePath{};
+			statement >> texturePath;
+			const Texture* pTexture{ texturePath.empty() ? nullptr : pScene->GetTexture(directory + texturePath) };
+
+			isValid = !pScene->m_MeshPtrs.empty() && pTexture != nullptr;
+			if(isValid)
+			{
+				Mesh* pMesh{ pScene->m_MeshPtrs.back() };
+				SoftwareMaterial material{ pMesh->GetMaterial() };
+				if(command == "diffuse")
+					material.pDiffuseMap = pTexture;
+				else if(command == "normal")
+					material.pNormalMap = pTexture;
+				else if(command == "specular")
+					material.pSpecularMap = pTexture;
+				else
+					material.pGlossinessMap = pTexture;
+				pMesh->SetMaterial(material);
+			}
+		}
+		else
+		{
+			isValid = false;
+		}
+
+		if(!isValid)
+		{
+			std::cout << "BatchScene: " << path << "(" << lineNumber << "): can't use \"" << line << "\"\n";
+			delete pScene;
+			return nullptr;
+		}
+	}
+
+	// The pixel shader samples all 4 maps
+	for(const Mesh* pMesh : pScene->m_MeshPtrs)
+	{
+		const SoftwareMaterial& material{ pMesh->GetMaterial() };
+		if(!material.pDiffuseMap || !material.pNormalMap || !material.pSpecularMap || !material.pGlossinessMap)
+		{
+			std::cout << "BatchScene: " << path << ": every mesh needs a diffuse, normal, specular and gloss map\n";
+			delete pScene;
+			return nullptr;
+		}
+
+		// Build the cached matrices now, FillScene can run on several threads at once
+		pMesh->GetWorldMatrix();
+		pMesh->GetNormalMatrix();
+	}
+
+	return pScene;
+}
+
+void BatchScene::FillScene(const Camera& camera, SoftwareScene& scene) const
+{
+	scene.viewProjectionMatrix = camera.GetViewProjectionMatrix();
+	scene.cameraOrigin = camera.GetOrigin();
+
+	scene.meshes.clear();
+	for(const Mesh* pMesh : m_MeshPtrs)
+	{
+		// Whole mesh outside of the view frustum, skip all of its work
+		if(!pMesh->Visible() || !camera.IsSphereInFrustum(pMesh->GetWorldBoundingCenter(), pMesh->GetWorldBoundingRadius()))
+			continue;
+
+		scene.meshes.push_back({ pMesh, pMesh->GetWorldMatrix(), pMesh->GetNormalMatrix() });
+	}
+}
+
+const Texture* BatchScene::GetTexture(const std::string& path)
+{
+	for(size_t i{ 0 }; i < m_TexturePaths.size(); ++i)
+	{
+		if(m_TexturePaths[i] == path)
+			return m_TexturePtrs[i];
+	}
+
+	Texture* pTexture{ ImageIO::LoadTexture(path) };
+	if(pTexture)
+	{
+		m_TexturePtrs.push_back(pTexture);
+		m_TexturePaths.push_back(path);
+	}
+	return pTexture;
+}
+
+bool LoadCameraPath(const std::string& path, std::vector<CameraPathFrame>& frames)
+{
+	std::ifstream file{ path };
+	if(!file)
+	{
+		std::cout << "CameraPath: could not open " << path << "\n";
+		return false;
+	}
+
+	frames.clear();
+	std::string line{};
+	int lineNumber{ 0 };
+	while(std::getline(file, line))
+	{
+		++lineNumber;
+		if(!GetStatement(line))
+			continue;
+
+		std::istringstream statement{ line };
+		CameraPathFrame frame{};
+		if(!(statement >> frame.origin.x >> frame.origin.y >> frame.origin.z >> frame.pitch >> frame.yaw))
+		{
+			std::cout << "CameraPath: " << path << "(" << lineNumber << "): expected \"x y z pitch yaw\"\n";
+			return false;
+		}
+		frames.push_back(frame);
+	}
+
+	return true;
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "Math.h"
+#include "SoftwareRasterizer.h"
+
+using namespace dae;
+
+class Camera;
+class Mesh;
+class Texture;
+
+// Meshes + textures for the batch tools, loaded from a scene file
+// One statement per line, # starts a comment, paths are relative to the scene file:
+//   mesh <file.obj> [x y z]                      new mesh, at that position
+//   rotate <yaw>                                 rotates the last mesh around Y, degrees
+//   diffuse|normal|specular|gloss <image.png>    map of the last mesh
+class BatchScene final
+{
+public:
+	~BatchScene();
+	BatchScene(const BatchScene&) = delete;
+	BatchScene& operator=(const BatchScene&) = delete;
+	BatchScene(BatchScene&&) = delete;
+	BatchScene& operator=(BatchScene&&) = delete;
+
+	// nullptr when the file or anything it refers to can't be loaded
+	static BatchScene* LoadFromFile(const std::string& path);
+
+	// The meshes seen by camera: camera + meshes inside its frustum
+	// Only reads the scene, safe to call from several threads at once
+	void FillScene(const Camera& camera, SoftwareScene& scene) const;
+
+	const std::vector<Mesh*>& GetMeshes() const { return m_MeshPtrs; };
+
+private:
+	BatchScene() = default;
+
+	std::vector<Mesh*> m_MeshPtrs{};
+	std::vector<Texture*> m_TexturePtrs{};
+	std::vector<std::string> m_TexturePaths{};  // Same order as m_TexturePtrs, meshes sharing a map share the texture
+
+	const Texture* GetTexture(const std::string& path);
+};
+
+// One frame of a camera path, pitch and yaw in degrees (see Camera::SetView)
+struct CameraPathFrame
+{
+	Vector3 origin{};
+	float pitch{};
+	float yaw{};
+};
+
+// Camera path file: one frame per line "x y z pitch yaw", # starts a comment
+// Returns false when the file can't be read or a line doesn't parse
+bool LoadCameraPath(const std::string& path, std::vector<CameraPathFrame>& frames);
@@ -0,0 +1,301 @@
+// Frame time benchmark of the software rasterizer: fixed scenes, scripted cameras, nothing written to disk
+// Every scene renders the same frames for every configuration, so runs of different builds (or machines) compare directly
+// Builds wherever the SoftwareRasterizer library builds (see CMakeLists.txt)
+#include "BatchScene.h"
+#include "Camera.h"
+#include "ImageIO.h"
+#include "JobSystem.h"
+#include "SoftwareRasterizer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace dae;
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	// Camera orbits center at distance, pitch degrees above it, sweeping sweepAngle degrees over the run
+	struct BenchmarkScene
+	{
+		const char* name{};
+		const char* scenePath{};
+		Vector3 center{};
+		float distance{};
+		float pitch{};
+		float startAngle{};
+		float sweepAngle{};
+	};
+
+	const BenchmarkScene g_Scenes[]
+	{
+		{ "vehicle_far", "Resources/vehicle.scene", { 0.0f, 0.0f, 50.0f }, 90.0f, -10.0f, 0.0f, 90.0f },
+		{ "vehicle_mid", "Resources/vehicle.scene", { 0.0f, 0.0f, 50.0f }, 50.0f, -10.0f, 0.0f, 90.0f },
+		{ "vehicle_near", "Resources/vehicle.scene", { 0.0f, 0.0f, 50.0f }, 28.0f, -10.0f, 0.0f, 90.0f },
+		{ "closeup", "Resources/vehicle.scene", { 0.0f, 0.0f, 50.0f }, 14.0f, -10.0f, 15.0f, 30.0f },  // Fills the screen
+		{ "instances", "Resources/instances.scene", { 0.0f, 0.0f, 50.0f }, 70.0f, -35.0f, 0.0f, 90.0f },
+		{ "fire", "Resources/fire.scene", { 0.0f, 0.0f, 61.0f }, 40.0f, 0.0f, 170.0f, 20.0f },  // Overdraw
+	};
+
+	struct BenchmarkConfig
+	{
+		std::string name{};
+		int width{};
+		int height{};
+		SoftwareRenderSettings render{};
+	};
+
+	struct BenchmarkSettings
+	{
+		uint32_t NumFrames{ 120 };
+		uint32_t NumWarmupFrames{ 10 };  // Rendered before the measured frames, not counted
+		std::string SceneFilter{};  // Only the scenes with this in their name
+		bool UseAllConfigs{ false };
+		std::string CsvPath{};
+		JobSystemSettings JobSystem{};
+	};
+
+	struct FrameTimeStats
+	{
+		double mean{};
+		double p50{};
+		double p95{};
+		double p99{};
+		double max{};
+	};
+
+	const char* GetShadingModeName(SoftwareRenderSettings::ShadingModes shadingMode)
+	{
+		switch(shadingMode)
+		{
+		case SoftwareRenderSettings::ShadingModes::ObservedArea: return "observedarea";
+		case SoftwareRenderSettings::ShadingModes::Diffuse: return "diffuse";
+		case SoftwareRenderSettings::ShadingModes::Specular: return "specular";
+		default: return "combined";
+		}
+	}
+
+	const char* GetCullModeName(SoftwareRenderSettings::CullModes cullMode)
+	{
+		switch(cullMode)
+		{
+		case SoftwareRenderSettings::CullModes::FrontFace: return "frontcull";
+		case SoftwareRenderSettings::CullModes::None: return "nocull";
+		default: return "backcull";
+		}
+	}
+
+	BenchmarkConfig MakeConfig(int width, int height, SoftwareRenderSettings::ShadingModes shadingMode, bool useNormalMap, SoftwareRenderSettings::CullModes cullMode)
+	{
+		BenchmarkConfig config{};
+		config.width = width;
+		config.height = height;
+		config.render.ShadingMode = shadingMode;
+		config.render.UseNormalMap = useNormalMap;
+		config.render.CullMode = cullMode;
+		config.name = std::to_string(width) + "x" + std::to_string(height) + " " + GetShadingModeName(shadingMode) + " " +
+			(useNormalMap ? "normalmap" : "nonormalmap") + " " + GetCullModeName(cullMode);
+		return config;
+	}
+
+	// Default: the interactive renderer's settings, then one setting changed at a time. All: every combination
+	std::vector<BenchmarkConfig> GetConfigs(bool useAllConfigs)
+	{
+		using CullModes = SoftwareRenderSettings::CullModes;
+		using ShadingModes = SoftwareRenderSettings::ShadingModes;
+
+		const int resolutions[][2]{ { 640, 480 }, { 1280, 720 }, { 1920, 1080 } };
+		const ShadingModes shadingModes[]{ ShadingModes::Combined, ShadingModes::ObservedArea, ShadingModes::Diffuse, ShadingModes::Specular };
+		const CullModes cullModes[]{ CullModes::BackFace, CullModes::FrontFace, CullModes::None };
+
+		std::vector<BenchmarkConfig> configs{};
+		if(useAllConfigs)
+		{
+			for(const auto& resolution : resolutions)
+				for(ShadingModes shadingMode : shadingModes)
+					for(bool useNormalMap : { true, false })
+						for(CullModes cullMode : cullModes)
+							configs.push_back(MakeConfig(resolution[0], resolution[1], shadingMode, useNormalMap, cullMode));
+			return configs;
+		}
+
+		configs.push_back(MakeConfig(640, 480, ShadingModes::Combined, true, CullModes::BackFace));
+		for(ShadingModes shadingMode : { ShadingModes::ObservedArea, ShadingModes::Diffuse, ShadingModes::Specular })
+			configs.push_back(MakeConfig(640, 480, shadingMode, true, CullModes::BackFace));
+		configs.push_back(MakeConfig(640, 480, ShadingModes::Combined, false, CullModes::BackFace));
+		for(CullModes cullMode : { CullModes::FrontFace, CullModes::None })
+			configs.push_back(MakeConfig(640, 480, ShadingModes::Combined, true, cullMode));
+		for(size_t i{ 1 }; i < std::size(resolutions); ++i)
+			configs.push_back(MakeConfig(resolutions[i][0], resolutions[i][1], ShadingModes::Combined, true, CullModes::BackFace));
+		return configs;
+	}
+
+	// Same view for the same frame every run, a function of the frame number only
+	CameraPathFrame GetCameraFrame(const BenchmarkScene& scene, uint32_t frameIndex, uint32_t numFrames)
+	{
+		const float angle{ scene.startAngle + scene.sweepAngle * float(frameIndex) / float(std::max(1u, numFrames - 1)) };
+		const float horizontalDistance{ scene.distance * std::cos(scene.pitch * TO_RADIANS) };
+
+		CameraPathFrame frame{};
+		frame.origin = scene.center + Vector3{ horizontalDistance * std::sin(angle * TO_RADIANS), -scene.distance * std::sin(scene.pitch * TO_RADIANS), horizontalDistance * std::cos(angle * TO_RADIANS) };
+		frame.pitch = scene.pitch;
+		frame.yaw = angle - 180.0f;  // Facing the center
+		return frame;
+	}
+
+	// Nearest rank percentiles
+	FrameTimeStats GetStats(std::vector<double> frameMs)
+	{
+		std::sort(frameMs.begin(), frameMs.end());
+		const auto getPercentile = [&frameMs](double percentile)
+		{
+			const size_t rank{ size_t(std::ceil(percentile / 100.0 * double(frameMs.size()))) };
+			return frameMs[std::clamp(rank, size_t(1), frameMs.size()) - 1];
+		};
+
+		FrameTimeStats stats{};
+		for(double ms : frameMs)
+			stats.mean += ms;
+		stats.mean /= double(frameMs.size());
+		stats.p50 = getPercentile(50.0);
+		stats.p95 = getPercentile(95.0);
+		stats.p99 = getPercentile(99.0);
+		stats.max = frameMs.back();
+		return stats;
+	}
+
+	void PrintUsage()
+	{
+		std::cout <<
+			"Usage: Benchmark [options]\n"
+			"    -frames <count>       Measured frames per scene and configuration (default 120)\n"
+			"    -warmup <count>       Frames rendered before measuring (default 10)\n"
+			"    -scene <name>         Only the scenes with this in their name: vehicle_far, vehicle_mid, vehicle_near, closeup, instances, fire\n"
+			"    -all                  Every combination of shading mode, normal map, cull mode and resolution, instead of one change at a time\n"
+			"    -csv <file>           Also write the results as CSV\n"
+			"    -workers <count>      Rasterizer worker threads (default: one per core - 1)\n"
+			"    -pin                  Pin the workers to their own core\n";
+	}
+
+	bool ParseArguments(int argc, char* args[], BenchmarkSettings& settings)
+	{
+		for(int i{ 1 }; i < argc; ++i)
+		{
+			const std::string argument{ args[i] };
+			const bool hasValue{ i + 1 < argc };
+			if(argument == "-frames" && hasValue)
+				settings.NumFrames = uint32_t(std::max(1, std::atoi(args[++i])));
+			else if(argument == "-warmup" && hasValue)
+				settings.NumWarmupFrames = uint32_t(std::max(0, std::atoi(args[++i])));
+			else if(argument == "-scene" && hasValue)
+				settings.SceneFilter = args[++i];
+			else if(argument == "-all")
+				settings.UseAllConfigs = true;
+			else if(argument == "-csv" && hasValue)
+				settings.CsvPath = args[++i];
+			else if(argument == "-workers" && hasValue)
+				settings.JobSystem.NumWorkers = std::atoi(args[++i]);
+			else if(argument == "-pin")
+				settings.JobSystem.PinWorkers = true;
+			else
+				return false;
+		}
+		return true;
+	}
+}
+
+int main(int argc, char* args[])
+{
+	BenchmarkSettings settings{};
+	if(!ParseArguments(argc, args, settings))
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	std::ofstream csv{};
+	if(!settings.CsvPath.empty())
+	{
+		csv.open(settings.CsvPath);
+		if(!csv)
+		{
+			std::cout << "Benchmark: could not open " << settings.CsvPath << "\n";
+			return 1;
+		}
+		csv << "scene,config,width,height,frames,mean_ms,p50_ms,p95_ms,p99_ms,max_ms\n";
+	}
+
+	JobSystem jobSystem{ settings.JobSystem };
+	const std::vector<BenchmarkConfig> configs{ GetConfigs(settings.UseAllConfigs) };
+	std::cout << "Benchmark: " << settings.NumFrames << " frames (+ " << settings.NumWarmupFrames << " warmup) per scene and configuration, "
+		<< jobSystem.GetNumWorkers() << " workers + main thread\n";
+	std::printf("%-14s %-42s %9s %9s %9s %9s %9s\n", "scene", "config", "mean ms", "p50 ms", "p95 ms", "p99 ms", "max ms");
+
+	uint32_t numScenes{ 0 };
+	for(const BenchmarkScene& benchmarkScene : g_Scenes)
+	{
+		if(std::string{ benchmarkScene.name }.find(settings.SceneFilter) == std::string::npos)
+			continue;
+		++numScenes;
+
+		BatchScene* pScene{ BatchScene::LoadFromFile(benchmarkScene.scenePath) };
+		if(!pScene)
+			return 1;
+
+		for(const BenchmarkConfig& config : configs)
+		{
+			SoftwareRasterizer rasterizer{ config.width, config.height, jobSystem, {}, ImageIO::GetRGBAPacking() };
+			std::vector<uint32_t> pixels(size_t(config.width) * config.height);
+			rasterizer.FirstTouch(pixels.data(), config.width);
+
+			Camera camera{ {}, 45.0f, 1.0f, 100.0f, config.width / float(config.height) };
+			SoftwareScene softwareScene{};
+			std::vector<double> frameMs{};
+			frameMs.reserve(settings.NumFrames);
+
+			// Warmup frames repeat the first view
+			for(uint32_t i{ 0 }; i < settings.NumWarmupFrames + settings.NumFrames; ++i)
+			{
+				const uint32_t frameIndex{ i < settings.NumWarmupFrames ? 0 : i - settings.NumWarmupFrames };
+				const CameraPathFrame cameraFrame{ GetCameraFrame(benchmarkScene, frameIndex, settings.NumFrames) };
+
+				// A frame: scene setup (culling included) + render
+				const Clock::time_point frameStart{ Clock::now() };
+				camera.SetView(cameraFrame.origin, cameraFrame.pitch, cameraFrame.yaw);
+				pScene->FillScene(camera, softwareScene);
+				rasterizer.Render(softwareScene, config.render, pixels.data(), config.width);
+				const double ms{ std::chrono::duration<double, std::milli>(Clock::now() - frameStart).count() };
+
+				if(i >= settings.NumWarmupFrames)
+					frameMs.push_back(ms);
+			}
+
+			const FrameTimeStats stats{ GetStats(frameMs) };
+			std::printf("%-14s %-42s %9.3f %9.3f %9.3f %9.3f %9.3f\n", benchmarkScene.name, config.name.c_str(), stats.mean, stats.p50, stats.p95, stats.p99, stats.max);
+			std::fflush(stdout);
+
+			if(csv.is_open())
+			{
+				csv << benchmarkScene.name << "," << config.name << "," << config.width << "," << config.height << "," << frameMs.size() << ","
+					<< stats.mean << "," << stats.p50 << "," << stats.p95 << "," << stats.p99 << "," << stats.max << "\n";
+			}
+		}
+
+		delete pScene;
+	}
+
+	if(numScenes == 0)
+	{
+		std::cout << "Benchmark: no scene matches \"" << settings.SceneFilter << "\"\n";
+		return 1;
+	}
+	return 0;
+}
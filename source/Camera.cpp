@@ -1,21 +1,13 @@
-#include "pch.h"
 #include "Camera.h"
 
-void Camera::Update(const Timer* pTimer)
+void Camera::Update(const Timer* pTimer, const CameraInput& input)
 {
 	const float deltaTime{ pTimer->GetElapsed() };
 
 	bool hasMoved{ false };
 
-	// Catch keyboard input
-	const uint8_t* pKeyboardState{ SDL_GetKeyboardState(nullptr) };
-
-	// Catch mouse input
-	int mouseX{}, mouseY{};
-	const uint32_t mouseState{ SDL_GetRelativeMouseState(&mouseX, &mouseY) };
-
 	// Keyboard movement of the camera
-	if(pKeyboardState[SDL_SCANCODE_LSHIFT])
+	if(input.boost)
 	{
 		m_CurrentMovementSpeed = m_BoostMovementSpeed;
 	}
@@ -23,68 +15,70 @@ void Camera::Update(const Timer* pTimer)
 	{
 		m_CurrentMovementSpeed = m_BaseMovementSpeed;
 	}
-	if(pKeyboardState[SDL_SCANCODE_W] || pKeyboardState[SDL_SCANCODE_UP])
+	if(input.moveForward)
 	{
 		m_Origin += m_Forward * m_CurrentMovementSpeed * m_KeyboardMovementSpeedMultiplier * deltaTime;
 		hasMoved = true;
 	}
-	if(pKeyboardState[SDL_SCANCODE_S] || pKeyboardState[SDL_SCANCODE_DOWN])
+	if(input.moveBackward)
 	{
 		m_Origin -= m_Forward * m_CurrentMovementSpeed * m_KeyboardMovementSpeedMultiplier * deltaTime;
 		hasMoved = true;
 	}
-	if(pKeyboardState[SDL_SCANCODE_D] || pKeyboardState[SDL_SCANCODE_RIGHT])
+	if(input.moveRight)
 	{
 		m_Origin += m_Right * m_CurrentMovementSpeed * m_KeyboardMovementSpeedMultiplier * deltaTime;
 		hasMoved = true;
 	}
-	if(pKeyboardState[SDL_SCANCODE_A] || pKeyboardState[SDL_SCANCODE_LEFT])
+	if(input.moveLeft)
 	{
 		m_Origin -= m_Right * m_CurrentMovementSpeed * m_KeyboardMovementSpeedMultiplier * deltaTime;
 		hasMoved = true;
 	}
-	if(pKeyboardState[SDL_SCANCODE_SPACE])
+	if(input.moveUp)
 	{
 		m_Origin += Vector3::UnitY * m_CurrentMovementSpeed * m_KeyboardMovementSpeedMultiplier * deltaTime;
 		hasMoved = true;
 	}
 
-	if(pKeyboardState[SDL_SCANCODE_LCTRL])
+	if(input.moveDown)
 	{
 		m_Origin -= Vector3::UnitY * m_CurrentMovementSpeed * m_KeyboardMovementSpeedMultiplier * deltaTime;
 		hasMoved = true;
 	}
 
-	if(pKeyboardState[SDL_SCANCODE_I])
+	if(input.pitchUp)
 	{
 		m_CameraOrientation.x += m_KeyboardRotationSpeed * deltaTime;
 		hasMoved = true;
 	}
-	if(pKeyboardState[SDL_SCANCODE_K])
+	if(input.pitchDown)
 	{
 		m_CameraOrientation.x -= m_KeyboardRotationSpeed * deltaTime;
 		hasMoved = true;
 	}
-	if(pKeyboardState[SDL_SCANCODE_J])
+	if(input.yawLeft)
 	{
 		m_CameraOrientation.y -= m_KeyboardRotationSpeed * deltaTime;
 		hasMoved = true;
 	}
-	if(pKeyboardState[SDL_SCANCODE_L])
+	if(input.yawRight)
 	{
 		m_CameraOrientation.y += m_KeyboardRotationSpeed * deltaTime;
 		hasMoved = true;
 	}
 
 	// Mouse movements / rotation of the camera
-	if((mouseState & SDL_BUTTON(SDL_BUTTON_LEFT)) && mouseState & SDL_BUTTON(SDL_BUTTON_RIGHT))
+	const int mouseX{ input.mouseX };
+	const int mouseY{ input.mouseY };
+	if(input.leftMouseButton && input.rightMouseButton)
 	{
 		// mouseX yaw left & right, mouse Y moves forwards & backwards
 		const float upwards = -mouseY * m_RotationSpeed;  // Not rotation but needed same value ish as this
 		m_Origin += m_Up * upwards;
 		hasMoved = true;
 	}
-	else if(mouseState & SDL_BUTTON(SDL_BUTTON_LEFT))
+	else if(input.leftMouseButton)
 	{
 		// mouseX yaw left & right, mouse Y moves forwards & backwards
 		const float forwards = -mouseY * m_RotationSpeed;
@@ -94,7 +88,7 @@ void Camera::Update(const Timer* pTimer)
 		m_CameraOrientation.y += yaw;
 		hasMoved = true;
 	}
-	else if(mouseState & SDL_BUTTON(SDL_BUTTON_RIGHT))
+	else if(input.rightMouseButton)
 	{
 		// Look around the current origin
 		const float pitch = -mouseY * m_RotationSpeed;
@@ -108,17 +102,7 @@ void Camera::Update(const Timer* pTimer)
 	// Update the camera stuff only when an input was received;
 	if(hasMoved)
 	{
-		m_CameraOrientation.x = Clamp(m_CameraOrientation.x, -89.9f, 89.9f);
-		m_CameraOrientation.y = Wrap(m_CameraOrientation.y, -180.f, 180.f);
-		//m_CameraOrientation.z = Wrap(m_CameraOrientation.z, -10.0f, 10.0f);
-
-		//const Matrix finalRotation = Matrix::CreateRotation(m_CameraOrientation * TO_RADIANS);
-		const Matrix finalRotation = Matrix::CreateRotationX(m_CameraOrientation.x * TO_RADIANS) * Matrix::CreateRotationY(m_CameraOrientation.y * TO_RADIANS);
-		m_Forward = finalRotation.TransformVector(Vector3::UnitZ);
-		m_Forward.Normalize();
-
-		m_Up = finalRotation.GetAxisY();
-		m_Right = finalRotation.GetAxisX();
+		CalculateAxes();
 
 		//UpdateViewMatrix = true;
 		//CalculateProjectionMatrix();
@@ -127,13 +111,78 @@ void Camera::Update(const Timer* pTimer)
 
 }
 
+void Camera::SetView(const Vector3& origin, float pitch, float yaw)
+{
+	m_Origin = origin;
+	m_CameraOrientation.x = pitch;
+	m_CameraOrientation.y = yaw;
+
+	CalculateAxes();
+	CalculateViewMatrix();
+}
+
+void Camera::CalculateAxes()
+{
+	m_CameraOrientation.x = Clamp(m_CameraOrientation.x, -89.9f, 89.9f);
+	m_CameraOrientation.y = Wrap(m_CameraOrientation.y, -180.f, 180.f);
+	//m_CameraOrientation.z = Wrap(m_CameraOrientation.z, -10.0f, 10.0f);
+
+	//const Matrix finalRotation = Matrix::CreateRotation(m_CameraOrientation * TO_RADIANS);
+	const Matrix finalRotation = Matrix::CreateRotationX(m_CameraOrientation.x * TO_RADIANS) * Matrix::CreateRotationY(m_CameraOrientation.y * TO_RADIANS);
+	m_Forward = finalRotation.TransformVector(Vector3::UnitZ);
+	m_Forward.Normalize();
+
+	m_Up = finalRotation.GetAxisY();
+	m_Right = finalRotation.GetAxisX();
+}
+
 void Camera::CalculateViewMatrix()
 {
 	m_InvViewMatrix = Matrix::CreateLookAtLH(m_Origin, m_Forward, m_Up);
-	m_ViewMatrix = m_InvViewMatrix.Inverse();
+	// The look-at matrix only rotates and translates, no need for a full inverse
+	m_ViewMatrix = Matrix::InverseRigid(m_InvViewMatrix);
+
+	CalculateViewProjectionMatrix();
 }
 
 void Camera::CalculateProjectionMatrix()
 {
 	m_ProjectionMatrix = Matrix::CreatePerspectiveFovLH(m_FovRatio, m_AspectRatio, m_NearPlane, m_FarPlane);
+
+	CalculateViewProjectionMatrix();
+}
+
+void Camera::CalculateViewProjectionMatrix()
+{
+	m_ViewProjectionMatrix = m_ViewMatrix * m_ProjectionMatrix;
+
+	// Gribb-Hartmann plane extraction, with row vectors every clip component is a column of the view projection matrix
+	const Matrix& viewProjection{ m_ViewProjectionMatrix };
+	const Vector4 columnX{ viewProjection[0].x, viewProjection[1].x, viewProjection[2].x, viewProjection[3].x };
+	const Vector4 columnY{ viewProjection[0].y, viewProjection[1].y, viewProjection[2].y, viewProjection[3].y };
+	const Vector4 columnZ{ viewProjection[0].z, viewProjection[1].z, viewProjection[2].z, viewProjection[3].z };
+	const Vector4 columnW{ viewProjection[0].w, viewProjection[1].w, viewProjection[2].w, viewProjection[3].w };
+
+	m_FrustumPlanes[0] = columnW + columnX;  // Left
+	m_FrustumPlanes[1] = columnW - columnX;  // Right
+	m_FrustumPlanes[2] = columnW + columnY;  // Bottom
+	m_FrustumPlanes[3] = columnW - columnY;  // Top
+	m_FrustumPlanes[4] = columnZ;			 // Near (DirectX depth goes from 0 to w)
+	m_FrustumPlanes[5] = columnW - columnZ;  // Far
+
+	// Normalize so the plane equation gives the actual distance, needed for the sphere test
+	for(Vector4& plane : m_FrustumPlanes)
+	{
+		plane = plane * (1.0f / plane.GetXYZ().Magnitude());
+	}
+}
+
+bool Camera::IsSphereInFrustum(const Vector3& center, float radius) const
+{
+	for(const Vector4& plane : m_FrustumPlanes)
+	{
+		if(Vector3::Dot(plane.GetXYZ(), center) + plane.w < -radius)
+			return false;
+	}
+	return true;
 }
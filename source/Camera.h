@@ -1,10 +1,33 @@
 #pragma once
 //#include "MathHelpers.h"
 #include "Math.h"
-#include "Camera.h"
+#include "Timer.h"
 
 using namespace dae;
 
+// Keys and mouse of one frame that move the camera, filled in by whoever reads the input (the camera doesn't know SDL)
+struct CameraInput
+{
+	bool boost{ false };
+	bool moveForward{ false };
+	bool moveBackward{ false };
+	bool moveRight{ false };
+	bool moveLeft{ false };
+	bool moveUp{ false };
+	bool moveDown{ false };
+
+	bool pitchUp{ false };
+	bool pitchDown{ false };
+	bool yawLeft{ false };
+	bool yawRight{ false };
+
+	// Relative mouse movement since the last frame
+	int mouseX{};
+	int mouseY{};
+	bool leftMouseButton{ false };
+	bool rightMouseButton{ false };
+};
+
 
 class Camera final
 {
@@ -29,13 +52,22 @@ public:
 	Camera(Camera&&) = delete;
 	Camera& operator=(Camera&&) = delete;
 
-	void Update(const Timer* pTimer);
+	void Update(const Timer* pTimer, const CameraInput& input);
 
-	Matrix GetViewMatrix() const { return m_ViewMatrix; };
-	Matrix GetInverseViewMatrix() const { return Matrix::Inverse(m_ViewMatrix); };
-	Matrix GetProjectionMatrix() const { return m_ProjectionMatrix; };
+	// Jumps to a fixed view, pitch and yaw in degrees (same as the mouse/keyboard rotation)
+	void SetView(const Vector3& origin, float pitch, float yaw);
 
-	Vector3 GetOrigin() { return m_Origin; };
+	// Cached, only recalculated when the camera moved
+	const Matrix& GetViewMatrix() const { return m_ViewMatrix; };
+	const Matrix& GetInverseViewMatrix() const { return m_InvViewMatrix; };
+	const Matrix& GetProjectionMatrix() const { return m_ProjectionMatrix; };
+	const Matrix& GetViewProjectionMatrix() const { return m_ViewProjectionMatrix; };
+
+	// World space planes (normal pointing inwards), order: left, right, bottom, top, near, far
+	const Vector4* GetFrustumPlanes() const { return m_FrustumPlanes; };
+	bool IsSphereInFrustum(const Vector3& center, float radius) const;
+
+	const Vector3& GetOrigin() const { return m_Origin; };
 
 private:
 	// Camera Settings
@@ -70,9 +102,15 @@ private:
 	Matrix m_InvViewMatrix{};
 	Matrix m_ViewMatrix{};
 	Matrix m_ProjectionMatrix{};
+	Matrix m_ViewProjectionMatrix{};
+
+	static constexpr int m_NumFrustumPlanes{ 6 };
+	Vector4 m_FrustumPlanes[m_NumFrustumPlanes]{};
 
+	void CalculateAxes();  // Forward, up and right from the orientation
 	void CalculateViewMatrix();
 	void CalculateProjectionMatrix();
+	void CalculateViewProjectionMatrix();
 
 };
 
@@ -0,0 +1,64 @@
+#pragma once
+#include "Floatx4.h"
+#include "ColorRGB.h"
+
+namespace dae
+{
+	// 4 ColorRGB's in SoA layout, one per lane
+	struct ColorRGBx4
+	{
+		Floatx4 r{};
+		Floatx4 g{};
+		Floatx4 b{};
+
+		ColorRGBx4() = default;
+		ColorRGBx4(const Floatx4& _r, const Floatx4& _g, const Floatx4& _b) : r{ _r }, g{ _g }, b{ _b } {}
+		explicit ColorRGBx4(const ColorRGB& c) : r{ c.r }, g{ c.g }, b{ c.b } {}
+
+		ColorRGB GetLane(int lane) const
+		{
+			float rLanes[4], gLanes[4], bLanes[4];
+			r.Store(rLanes);
+			g.Store(gLanes);
+			b.Store(bLanes);
+			return { rLanes[lane], gLanes[lane], bLanes[lane] };
+		}
+
+		// Only lanes with a component above 1 get divided, the others keep their color
+		void MaxToOne()
+		{
+			const Floatx4 maxValue{ Max(r, Max(g, b)) };
+			const Floatx4 divisor{ Select(maxValue > 1.0f, maxValue, 1.0f) };
+			*this /= divisor;
+		}
+
+		static ColorRGBx4 Lerp(const ColorRGBx4& c1, const ColorRGBx4& c2, const Floatx4& factor)
+		{
+			return c1 + (c2 - c1) * factor;
+		}
+
+		#pragma region ColorRGBx4 (Member) Operators
+		ColorRGBx4& operator+=(const ColorRGBx4& c) { r += c.r; g += c.g; b += c.b; return *this; }
+		ColorRGBx4 operator+(const ColorRGBx4& c) const { return { r + c.r, g + c.g, b + c.b }; }
+		ColorRGBx4& operator-=(const ColorRGBx4& c) { r -= c.r; g -= c.g; b -= c.b; return *this; }
+		ColorRGBx4 operator-(const ColorRGBx4& c) const { return { r - c.r, g - c.g, b - c.b }; }
+		ColorRGBx4& operator*=(const ColorRGBx4& c) { r *= c.r; g *= c.g; b *= c.b; return *this; }
+		ColorRGBx4 operator*(const ColorRGBx4& c) const { return { r * c.r, g * c.g, b * c.b }; }
+		ColorRGBx4& operator*=(const Floatx4& s) { r *= s; g *= s; b *= s; return *this; }
+		ColorRGBx4 operator*(const Floatx4& s) const { return { r * s, g * s, b * s }; }
+		ColorRGBx4& operator/=(const Floatx4& s) { r /= s; g /= s; b /= s; return *this; }
+		ColorRGBx4 operator/(const Floatx4& s) const { return { r / s, g / s, b / s }; }
+		#pragma endregion
+	};
+
+	//ColorRGBx4 (Global) Operators
+	inline ColorRGBx4 operator*(const Floatx4& s, const ColorRGBx4& c)
+	{
+		return c * s;
+	}
+
+	inline ColorRGBx4 Select(const Floatx4& mask, const ColorRGBx4& a, const ColorRGBx4& b)
+	{
+		return { Select(mask, a.r, b.r), Select(mask, a.g, b.g), Select(mask, a.b, b.b) };
+	}
+}
@@ -0,0 +1,365 @@
+#include "DistributedRenderer.h"
+#include "Camera.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cerrno>
+#include <chrono>
+#include <ctime>
+#include <iostream>
+#include <new>
+#include <thread>
+
+#include <semaphore.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	constexpr int MaxProcesses{ 64 };
+	constexpr int WaitSliceMs{ 10 };  // How often the coordinator looks for dead or hung workers while it waits
+
+	// Absolute CLOCK_REALTIME time for sem_timedwait
+	timespec GetDeadline(int milliseconds)
+	{
+		timespec deadline{};
+		clock_gettime(CLOCK_REALTIME, &deadline);
+		deadline.tv_nsec += long(milliseconds % 1000) * 1'000'000;
+		deadline.tv_sec += milliseconds / 1000 + deadline.tv_nsec / 1'000'000'000;
+		deadline.tv_nsec %= 1'000'000'000;
+		return deadline;
+	}
+
+	// One per worker process, the coordinator writes the command and posts start, the worker writes the result and posts done
+	struct WorkerControl
+	{
+		sem_t start{};
+
+		// Command
+		uint32_t sequence{};
+		CameraPathFrame view{};
+		SoftwareRenderSettings settings{};
+		bool quit{ false };
+
+		// Result of the last band
+		std::atomic<uint32_t> completedSequence{ 0 };
+		float renderMs{};
+	};
+}
+
+// Start of the shared mapping, the framebuffer follows it
+struct DistributedRenderer::SharedMemory
+{
+	sem_t done{};  // Posted by every worker that finished a band
+	WorkerControl workers[MaxProcesses]{};
+
+	uint32_t* GetFramebuffer() { return reinterpret_cast<uint32_t*>(reinterpret_cast<char*>(this) + GetFramebufferOffset()); };
+	static constexpr size_t GetFramebufferOffset() { return (sizeof(SharedMemory) + 63) / 64 * 64; };
+};
+
+DistributedRenderer* DistributedRenderer::Create(int width, int height, float fovAngle, const BatchScene& scene, const DistributedSettings& settings, const PixelPacking& pixelPacking)
+{
+	assert(width > 0 && height > 0);
+	if(settings.NumProcesses < 1 || settings.NumProcesses > MaxProcesses)
+	{
+		std::cout << "DistributedRenderer: 1 to " << MaxProcesses << " processes\n";
+		return nullptr;
+	}
+
+	DistributedRenderer* pRenderer{ new DistributedRenderer{ width, height, settings } };
+
+	// Shared with every process forked from here on
+	pRenderer->m_SharedSize = SharedMemory::GetFramebufferOffset() + sizeof(uint32_t) * size_t(width) * height;
+	void* pMapping{ mmap(nullptr, pRenderer->m_SharedSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0) };
+	if(pMapping == MAP_FAILED)
+	{
+		std::cout << "DistributedRenderer: could not map " << pRenderer->m_SharedSize << " bytes of shared memory\n";
+		delete pRenderer;
+		return nullptr;
+	}
+
+	pRenderer->m_pShared = new(pMapping) SharedMemory{};
+	sem_init(&pRenderer->m_pShared->done, 1, 0);
+	for(WorkerControl& control : pRenderer->m_pShared->workers)
+		sem_init(&control.start, 1, 0);
+
+	for(uint32_t workerIndex{ 0 }; workerIndex < pRenderer->GetNumProcesses(); ++workerIndex)
+	{
+		const pid_t pid{ fork() };
+		if(pid == 0)
+			pRenderer->WorkerMain(workerIndex, fovAngle, scene, pixelPacking);
+
+		if(pid < 0)
+		{
+			std::cout << "DistributedRenderer: could not start process " << workerIndex << "\n";
+			continue;
+		}
+
+		Worker& worker{ pRenderer->m_Workers[workerIndex] };
+		worker.pid = pid;
+		worker.isAlive = true;
+	}
+
+	if(pRenderer->GetNumLiveProcesses() == 0)
+	{
+		delete pRenderer;
+		return nullptr;
+	}
+	return pRenderer;
+}
+
+DistributedRenderer::DistributedRenderer(int width, int height, const DistributedSettings& settings):
+	m_Width{ width },
+	m_Height{ height },
+	m_Settings{ settings },
+	m_Workers(size_t(settings.NumProcesses))
+{
+	if(settings.WorkersPerProcess >= 0)
+		m_WorkersPerProcess = static_cast<uint32_t>(settings.WorkersPerProcess);
+	else
+		m_WorkersPerProcess = std::max(1u, std::thread::hardware_concurrency() / uint32_t(settings.NumProcesses)) - 1;
+}
+
+DistributedRenderer::~DistributedRenderer()
+{
+	if(!m_pShared)
+		return;
+
+	for(uint32_t workerIndex{ 0 }; workerIndex < GetNumProcesses(); ++workerIndex)
+	{
+		if(!m_Workers[workerIndex].isAlive)
+			continue;
+
+		WorkerControl& control{ m_pShared->workers[workerIndex] };
+		control.quit = true;
+		sem_post(&control.start);
+	}
+
+	// Every worker gets the timeout to finish its band and shut down its threads
+	const Clock::time_point quitStart{ Clock::now() };
+	for(uint32_t workerIndex{ 0 }; workerIndex < GetNumProcesses(); ++workerIndex)
+	{
+		Worker& worker{ m_Workers[workerIndex] };
+		while(worker.isAlive)
+		{
+			if(waitpid(worker.pid, nullptr, WNOHANG) != 0)
+				worker.isAlive = false;
+			else if(Clock::now() - quitStart > std::chrono::milliseconds{ m_Settings.TimeoutMs })
+				KillWorker(workerIndex);
+			else
+				std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+		}
+	}
+
+	sem_destroy(&m_pShared->done);
+	for(WorkerControl& control : m_pShared->workers)
+		sem_destroy(&control.start);
+	munmap(m_pShared, m_SharedSize);
+}
+
+bool DistributedRenderer::RenderFrame(const CameraPathFrame& view, const SoftwareRenderSettings& settings, uint32_t* pTarget, int targetPitch)
+{
+	struct PendingBand
+	{
+		uint32_t workerIndex{};
+		uint32_t sequence{};
+		int firstRow{};
+		int lastRow{};
+		Clock::time_point start{};
+	};
+
+	AssignBands();
+
+	std::vector<PendingBand> pendingBands{};
+	for(uint32_t workerIndex{ 0 }; workerIndex < GetNumProcesses(); ++workerIndex)
+	{
+		const Worker& worker{ m_Workers[workerIndex] };
+		if(worker.isAlive && worker.firstRow < worker.lastRow)
+			pendingBands.push_back({ workerIndex, StartBand(workerIndex, view, settings, worker.firstRow, worker.lastRow), worker.firstRow, worker.lastRow, Clock::now() });
+	}
+
+	// Bands of workers that died on them, they go to the next worker that is free
+	std::vector<PendingBand> lostBands{};
+	while(!pendingBands.empty() || !lostBands.empty())
+	{
+		// Hand the lost bands to idle workers
+		for(uint32_t workerIndex{ 0 }; workerIndex < GetNumProcesses() && !lostBands.empty(); ++workerIndex)
+		{
+			const bool isBusy{ std::any_of(pendingBands.begin(), pendingBands.end(), [workerIndex](const PendingBand& band) { return band.workerIndex == workerIndex; }) };
+			if(!m_Workers[workerIndex].isAlive || isBusy)
+				continue;
+
+			PendingBand band{ lostBands.back() };
+			lostBands.pop_back();
+			band.workerIndex = workerIndex;
+			band.sequence = StartBand(workerIndex, view, settings, band.firstRow, band.lastRow);
+			band.start = Clock::now();
+			pendingBands.push_back(band);
+		}
+
+		if(pendingBands.empty())
+		{
+			std::cout << "DistributedRenderer: no worker process left\n";
+			return false;
+		}
+
+		const timespec deadline{ GetDeadline(WaitSliceMs) };
+		sem_timedwait(&m_pShared->done, &deadline);
+
+		for(size_t i{ 0 }; i < pendingBands.size();)
+		{
+			const PendingBand& band{ pendingBands[i] };
+			Worker& worker{ m_Workers[band.workerIndex] };
+			const WorkerControl& control{ m_pShared->workers[band.workerIndex] };
+
+			if(control.completedSequence.load(std::memory_order_acquire) == band.sequence)
+			{
+				// Smoothed, one slow frame (page faults, another process on the core) shouldn't swing the bands around
+				const float rowsPerMs{ float(band.lastRow - band.firstRow) / std::max(control.renderMs, 0.001f) };
+				worker.rowsPerMs = worker.rowsPerMs > 0.0f ? worker.rowsPerMs * 0.5f + rowsPerMs * 0.5f : rowsPerMs;
+			}
+			else if(waitpid(worker.pid, nullptr, WNOHANG) != 0)
+			{
+				std::cout << "DistributedRenderer: process " << band.workerIndex << " (pid " << worker.pid << ") died, rows "
+					<< band.firstRow << " - " << band.lastRow << " render on another one\n";
+				worker.isAlive = false;
+				lostBands.push_back(band);
+			}
+			else if(Clock::now() - band.start > std::chrono::milliseconds{ m_Settings.TimeoutMs })
+			{
+				std::cout << "DistributedRenderer: process " << band.workerIndex << " (pid " << worker.pid << ") hung, rows "
+					<< band.firstRow << " - " << band.lastRow << " render on another one\n";
+				KillWorker(band.workerIndex);
+				lostBands.push_back(band);
+			}
+			else
+			{
+				++i;
+				continue;
+			}
+
+			pendingBands.erase(pendingBands.begin() + i);
+		}
+	}
+
+	// Composite, every band is in the shared framebuffer by now
+	const uint32_t* pFramebuffer{ m_pShared->GetFramebuffer() };
+	for(int y{ 0 }; y < m_Height; ++y)
+		std::copy_n(pFramebuffer + size_t(y) * m_Width, m_Width, pTarget + size_t(y) * targetPitch);
+
+	return true;
+}
+
+uint32_t DistributedRenderer::GetNumLiveProcesses() const
+{
+	return static_cast<uint32_t>(std::count_if(m_Workers.begin(), m_Workers.end(), [](const Worker& worker) { return worker.isAlive; }));
+}
+
+void DistributedRenderer::WorkerMain(uint32_t workerIndex, float fovAngle, const BatchScene& scene, const PixelPacking& pixelPacking)
+{
+	const pid_t coordinatorPid{ getppid() };
+	WorkerControl& control{ m_pShared->workers[workerIndex] };
+
+	{
+		// Every process has cores of its own when pinned, its main thread first
+		JobSystemSettings jobSystemSettings{};
+		jobSystemSettings.NumWorkers = static_cast<int>(m_WorkersPerProcess);
+		jobSystemSettings.PinWorkers = m_Settings.PinThreads;
+		jobSystemSettings.ReserveMainCore = m_Settings.PinThreads;
+		jobSystemSettings.FirstCore = static_cast<int>(workerIndex * (m_WorkersPerProcess + 1));
+
+		JobSystem jobSystem{ jobSystemSettings };
+		SoftwareRasterizer rasterizer{ m_Width, m_Height, jobSystem, {}, pixelPacking };
+		Camera camera{ {}, fovAngle, 1.0f, 100.0f, m_Width / float(m_Height) };
+		SoftwareScene softwareScene{};
+
+		while(true)
+		{
+			// Don't outlive a coordinator that crashed
+			const timespec deadline{ GetDeadline(1000) };
+			if(sem_timedwait(&control.start, &deadline) != 0)
+			{
+				if(getppid() != coordinatorPid)
+					break;
+				continue;
+			}
+			if(control.quit)
+				break;
+
+			const Clock::time_point renderStart{ Clock::now() };
+			camera.SetView(control.view.origin, control.view.pitch, control.view.yaw);
+			scene.FillScene(camera, softwareScene);
+			rasterizer.Render(softwareScene, control.settings, m_pShared->GetFramebuffer(), m_Width);
+			control.renderMs = std::chrono::duration<float, std::milli>(Clock::now() - renderStart).count();
+
+			control.completedSequence.store(control.sequence, std::memory_order_release);
+			sem_post(&m_pShared->done);
+		}
+	}
+
+	// Skips the destructors and atexit handlers of the coordinator's copy of everything
+	_exit(0);
+}
+
+void DistributedRenderer::AssignBands()
+{
+	std::vector<uint32_t> liveWorkers{};
+	bool hasAllSpeeds{ true };
+	float totalRowsPerMs{ 0.0f };
+	for(uint32_t workerIndex{ 0 }; workerIndex < GetNumProcesses(); ++workerIndex)
+	{
+		Worker& worker{ m_Workers[workerIndex] };
+		worker.firstRow = worker.lastRow = 0;
+		if(!worker.isAlive)
+			continue;
+
+		liveWorkers.push_back(workerIndex);
+		hasAllSpeeds = hasAllSpeeds && worker.rowsPerMs > 0.0f;
+		totalRowsPerMs += worker.rowsPerMs;
+	}
+
+	// Equal bands until every worker has been measured
+	const bool isBalanced{ m_Settings.Balance && hasAllSpeeds };
+	const int numTileRows{ (m_Height + SoftwareTile::Size - 1) / SoftwareTile::Size };
+
+	float share{ 0.0f };
+	int firstTileRow{ 0 };
+	for(size_t i{ 0 }; i < liveWorkers.size(); ++i)
+	{
+		Worker& worker{ m_Workers[liveWorkers[i]] };
+		share += isBalanced ? worker.rowsPerMs / totalRowsPerMs : 1.0f / float(liveWorkers.size());
+
+		const int lastTileRow{ i + 1 == liveWorkers.size() ? numTileRows : std::clamp(int(share * float(numTileRows) + 0.5f), firstTileRow, numTileRows) };
+		worker.firstRow = std::min(firstTileRow * SoftwareTile::Size, m_Height);
+		worker.lastRow = std::min(lastTileRow * SoftwareTile::Size, m_Height);
+		firstTileRow = lastTileRow;
+	}
+}
+
+uint32_t DistributedRenderer::StartBand(uint32_t workerIndex, const CameraPathFrame& view, const SoftwareRenderSettings& settings, int firstRow, int lastRow)
+{
+	WorkerControl& control{ m_pShared->workers[workerIndex] };
+	control.sequence = ++m_Sequence;
+	control.view = view;
+	control.settings = settings;
+	control.settings.PipelinedFrames = false;
+	control.settings.FirstRow = firstRow;
+	control.settings.LastRow = lastRow;
+
+	sem_post(&control.start);
+	return control.sequence;
+}
+
+void DistributedRenderer::KillWorker(uint32_t workerIndex)
+{
+	Worker& worker{ m_Workers[workerIndex] };
+	kill(worker.pid, SIGKILL);
+	waitpid(worker.pid, nullptr, 0);
+	worker.isAlive = false;
+}
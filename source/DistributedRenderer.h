@@ -0,0 +1,86 @@
+#pragma once
+#include "BatchScene.h"
+#include "SoftwareRasterizer.h"
+
+#include <cstdint>
+#include <sys/types.h>
+#include <vector>
+
+// Settings of the worker processes
+struct DistributedSettings
+{
+	// Worker processes, every one renders a band of rows of every frame
+	int NumProcesses{ 2 };
+
+	// Rasterizer workers in every process on top of its main thread, -1 = the cores split over the processes
+	int WorkersPerProcess{ -1 };
+
+	// Pin the threads of every process to cores of its own
+	bool PinThreads{ false };
+
+	// Give the processes that finished their band faster a larger band next frame, instead of equal bands
+	bool Balance{ true };
+
+	// A process that takes longer than this on one band is considered hung: it gets killed and its band goes to another one
+	int TimeoutMs{ 5000 };
+};
+
+// Sort-first rendering over local worker processes (POSIX, Linux)
+// The screen is split in horizontal bands, every process renders its band of the frame with its own SoftwareRasterizer + JobSystem
+// into a framebuffer in shared memory, the coordinator (the process that created this) composites the bands into the target
+// A process that crashes or hangs only loses its band: the band renders again on another process and the frame goes on without it
+class DistributedRenderer final
+{
+public:
+	// Forks the worker processes, call it before the calling process starts any thread (fork only copies the calling thread)
+	// The workers get a copy on write view of scene, it has to stay alive and unchanged in the coordinator until this is deleted
+	// nullptr when the shared memory or the processes can't be created
+	static DistributedRenderer* Create(int width, int height, float fovAngle, const BatchScene& scene, const DistributedSettings& settings = {}, const PixelPacking& pixelPacking = {});
+
+	~DistributedRenderer();
+	DistributedRenderer(const DistributedRenderer&) = delete;
+	DistributedRenderer& operator=(const DistributedRenderer&) = delete;
+	DistributedRenderer(DistributedRenderer&&) = delete;
+	DistributedRenderer& operator=(DistributedRenderer&&) = delete;
+
+	// Renders the frame seen from view on the workers and composites it into pTarget (width x height, pitch in pixels)
+	// PipelinedFrames is ignored, FirstRow and LastRow are set per process
+	// Returns false once no worker process is left
+	bool RenderFrame(const CameraPathFrame& view, const SoftwareRenderSettings& settings, uint32_t* pTarget, int targetPitch);
+
+	uint32_t GetNumProcesses() const { return static_cast<uint32_t>(m_Workers.size()); };
+	uint32_t GetNumLiveProcesses() const;
+	uint32_t GetWorkersPerProcess() const { return m_WorkersPerProcess; };
+
+private:
+	struct SharedMemory;
+	struct Worker
+	{
+		pid_t pid{ -1 };
+		bool isAlive{ false };
+		float rowsPerMs{ 0.0f };  // Smoothed speed of its last bands, 0 = nothing measured yet
+		int firstRow{};
+		int lastRow{};
+	};
+
+	DistributedRenderer(int width, int height, const DistributedSettings& settings);
+
+	int m_Width{};
+	int m_Height{};
+	uint32_t m_WorkersPerProcess{};
+	DistributedSettings m_Settings{};
+
+	SharedMemory* m_pShared{ nullptr };
+	size_t m_SharedSize{};
+	std::vector<Worker> m_Workers{};
+	uint32_t m_Sequence{ 0 };  // Goes up for every band handed out, tells finished bands apart from old ones
+
+	// Worker process side, never returns
+	[[noreturn]] void WorkerMain(uint32_t workerIndex, float fovAngle, const BatchScene& scene, const PixelPacking& pixelPacking);
+
+	// Splits the rows over the live processes, in whole tile rows so no tile gets rasterized by two processes
+	void AssignBands();
+	// Hands the band to the worker, returns the sequence number it will report back
+	uint32_t StartBand(uint32_t workerIndex, const CameraPathFrame& view, const SoftwareRenderSettings& settings, int firstRow, int lastRow);
+	void KillWorker(uint32_t workerIndex);
+};
@@ -1,5 +1,5 @@
 #pragma once
-class Texture;
+class HardwareTexture;
 class Effect
 {
 public:
@@ -1,6 +1,6 @@
 #include "pch.h"
 #include "EffectFire.h"
-#include "Texture.h"
+#include "HardwareTexture.h"
 
 EffectFire::EffectFire(ID3D11Device* pDevice, const std::wstring& assetFile):
 	Effect(pDevice, assetFile)
@@ -33,7 +33,7 @@ EffectFire::~EffectFire()
 
 }
 
-void EffectFire::SetDiffuseMap(Texture* pDiffuseTexture)
+void EffectFire::SetDiffuseMap(HardwareTexture* pDiffuseTexture)
 {
 	if(m_pDiffuseMapVariable)
 		m_pDiffuseMapVariable->SetResource(pDiffuseTexture->GetShaderResourceView());
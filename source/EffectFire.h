@@ -3,7 +3,7 @@
 #include "Effect.h" 
 
 
-class Texture;
+class HardwareTexture;
 
 class EffectFire final: public Effect
 {
@@ -31,7 +31,7 @@ public:
 	ID3DX11EffectMatrixVariable* GetWorldMatrixVariable() const { return m_pEffectWorldMatrixVariable; };
 
 
-	void SetDiffuseMap(Texture* pTexture);
+	void SetDiffuseMap(HardwareTexture* pTexture);
 
 private:
 	ID3DX11EffectMatrixVariable* m_pMatWorldViewProjVariable;
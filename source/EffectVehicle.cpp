@@ -1,6 +1,6 @@
 #include "pch.h"
 #include "EffectVehicle.h"
-#include "Texture.h"
+#include "HardwareTexture.h"
 
 EffectVehicle::EffectVehicle(ID3D11Device* pDevice, const std::wstring& assetFile):
 	Effect(pDevice, assetFile)
@@ -125,25 +125,25 @@ EffectVehicle::~EffectVehicle()
 
 }
 
-void EffectVehicle::SetDiffuseMap(Texture* pDiffuseTexture)
+void EffectVehicle::SetDiffuseMap(HardwareTexture* pDiffuseTexture)
 {
 	if(m_pDiffuseMapVar)
 		m_pDiffuseMapVar->SetResource(pDiffuseTexture->GetShaderResourceView());
 }
 
-void EffectVehicle::SetNormalMap(Texture* pTexture)
+void EffectVehicle::SetNormalMap(HardwareTexture* pTexture)
 {
 	if(m_pNormalMapVar)
 		m_pNormalMapVar->SetResource(pTexture->GetShaderResourceView());
 }
 
-void EffectVehicle::SetSpecularMap(Texture* pTexture)
+void EffectVehicle::SetSpecularMap(HardwareTexture* pTexture)
 {
 	if(m_pSpecularMapVar)
 		m_pSpecularMapVar->SetResource(pTexture->GetShaderResourceView());
 }
 
-void EffectVehicle::SetGlossinessMap(Texture* pTexture)
+void EffectVehicle::SetGlossinessMap(HardwareTexture* pTexture)
 {
 	if(m_pGlossinessMapVar)
 		m_pGlossinessMapVar->SetResource(pTexture->GetShaderResourceView());
@@ -2,7 +2,7 @@
 #include "Matrix.h"
 #include "Effect.h"
 
-class Texture;
+class HardwareTexture;
 
 using namespace dae;
 class EffectVehicle: public Effect
@@ -18,10 +18,10 @@ public:
 	EffectVehicle(EffectVehicle&&) = delete;
 	EffectVehicle& operator=(EffectVehicle&&) = delete;
 
-	void SetDiffuseMap(Texture* pTexture);
-	void SetNormalMap(Texture* pTexture);
-	void SetSpecularMap(Texture* pTexture);
-	void SetGlossinessMap(Texture* pTexture);
+	void SetDiffuseMap(HardwareTexture* pTexture);
+	void SetNormalMap(HardwareTexture* pTexture);
+	void SetSpecularMap(HardwareTexture* pTexture);
+	void SetGlossinessMap(HardwareTexture* pTexture);
 	
 	void SetLightDirection(Vector3 lightDirection);
 	void SetLightIntensity(float lightIntensity);
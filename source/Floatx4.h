@@ -0,0 +1,67 @@
+#pragma once
+#include <xmmintrin.h>
+
+namespace dae
+{
+	// 4 floats in one SSE register, the software rasterizer uses one lane per pixel.
+	// Comparisons return lane masks (all bits set per true lane), use them with Select / MoveMask.
+	struct Floatx4
+	{
+		__m128 value;
+
+		Floatx4() : value{ _mm_setzero_ps() } {}
+		Floatx4(__m128 _value) : value{ _value } {}
+		Floatx4(float scalar) : value{ _mm_set1_ps(scalar) } {}
+		Floatx4(float lane0, float lane1, float lane2, float lane3) : value{ _mm_setr_ps(lane0, lane1, lane2, lane3) } {}
+
+		static Floatx4 Load(const float* pLanes) { return _mm_loadu_ps(pLanes); }
+		void Store(float* pLanes) const { _mm_storeu_ps(pLanes, value); }
+
+		Floatx4& operator+=(const Floatx4& f) { value = _mm_add_ps(value, f.value); return *this; }
+		Floatx4& operator-=(const Floatx4& f) { value = _mm_sub_ps(value, f.value); return *this; }
+		Floatx4& operator*=(const Floatx4& f) { value = _mm_mul_ps(value, f.value); return *this; }
+		Floatx4& operator/=(const Floatx4& f) { value = _mm_div_ps(value, f.value); return *this; }
+	};
+
+	//Global Operators
+	inline Floatx4 operator+(const Floatx4& a, const Floatx4& b) { return _mm_add_ps(a.value, b.value); }
+	inline Floatx4 operator-(const Floatx4& a, const Floatx4& b) { return _mm_sub_ps(a.value, b.value); }
+	inline Floatx4 operator*(const Floatx4& a, const Floatx4& b) { return _mm_mul_ps(a.value, b.value); }
+	inline Floatx4 operator/(const Floatx4& a, const Floatx4& b) { return _mm_div_ps(a.value, b.value); }
+	inline Floatx4 operator-(const Floatx4& a) { return _mm_xor_ps(a.value, _mm_set1_ps(-0.0f)); }
+
+	inline Floatx4 operator<(const Floatx4& a, const Floatx4& b) { return _mm_cmplt_ps(a.value, b.value); }
+	inline Floatx4 operator<=(const Floatx4& a, const Floatx4& b) { return _mm_cmple_ps(a.value, b.value); }
+	inline Floatx4 operator>(const Floatx4& a, const Floatx4& b) { return _mm_cmpgt_ps(a.value, b.value); }
+	inline Floatx4 operator>=(const Floatx4& a, const Floatx4& b) { return _mm_cmpge_ps(a.value, b.value); }
+
+	// Mask operators
+	inline Floatx4 operator&(const Floatx4& a, const Floatx4& b) { return _mm_and_ps(a.value, b.value); }
+	inline Floatx4 operator|(const Floatx4& a, const Floatx4& b) { return _mm_or_ps(a.value, b.value); }
+
+	// One bit per lane, lane 0 is the least significant bit
+	inline int MoveMask(const Floatx4& mask)
+	{
+		return _mm_movemask_ps(mask.value);
+	}
+
+	// Per lane: mask ? a : b
+	inline Floatx4 Select(const Floatx4& mask, const Floatx4& a, const Floatx4& b)
+	{
+		return _mm_or_ps(_mm_and_ps(mask.value, a.value), _mm_andnot_ps(mask.value, b.value));
+	}
+
+	inline Floatx4 Min(const Floatx4& a, const Floatx4& b) { return _mm_min_ps(a.value, b.value); }
+	inline Floatx4 Max(const Floatx4& a, const Floatx4& b) { return _mm_max_ps(a.value, b.value); }
+	inline Floatx4 Sqrt(const Floatx4& a) { return _mm_sqrt_ps(a.value); }
+
+	inline Floatx4 Clamp(const Floatx4& v, const Floatx4& min, const Floatx4& max)
+	{
+		return Min(Max(v, min), max);
+	}
+
+	inline Floatx4 Saturate(const Floatx4& v)
+	{
+		return Clamp(v, 0.0f, 1.0f);
+	}
+}
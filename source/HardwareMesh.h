@@ -0,0 +1,38 @@
+#pragma once
+#include "Math.h"
+
+using namespace dae;
+
+class Effect;
+class Mesh;
+
+// DirectX side of a Mesh: its vertex + index buffer and the effect it renders with
+class HardwareMesh final
+{
+public:
+	// Copies the vertices and indices of mesh into the buffers, the mesh itself is not kept
+	HardwareMesh(ID3D11Device* pDevice, Effect* pEffect, const Mesh& mesh);
+
+	~HardwareMesh();
+	HardwareMesh(const HardwareMesh&) = delete;
+	HardwareMesh& operator=(const HardwareMesh&) = delete;
+	HardwareMesh(HardwareMesh&&) = delete;
+	HardwareMesh& operator=(HardwareMesh&&) = delete;
+
+	// worldMatrix is passed in instead of read from the transform, the mesh can already be moving on another thread
+	void Render(ID3D11DeviceContext* pDeviceContext, Matrix worldMatrix, Matrix worldViewProjMatrix, Matrix viewInverseMatrix);
+
+	Effect* GetEffect() const { return m_pEffect; }
+
+private:
+	Effect* m_pEffect{};
+
+	ID3DX11EffectTechnique* m_pTechnique{};
+
+	ID3D11InputLayout* m_pInputLayout{};
+
+	ID3D11Buffer* m_pVertexBuffer{};
+	ID3D11Buffer* m_pIndexBuffer{};
+
+	uint32_t m_NumIndices{};
+};
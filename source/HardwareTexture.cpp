@@ -0,0 +1,61 @@
+#include "pch.h"
+#include "HardwareTexture.h"
+#include "Texture.h"
+
+HardwareTexture::~HardwareTexture()
+{
+	Utils::SafeRelease(m_pShaderResourceView);
+	Utils::SafeRelease(m_pResource);
+}
+
+// Static function
+HardwareTexture* HardwareTexture::Create(ID3D11Device* pDevice, const Texture& texture)
+{
+	return new HardwareTexture(pDevice, texture);
+}
+
+HardwareTexture::HardwareTexture(ID3D11Device* pDevice, const Texture& texture)
+{
+	// Assemble the resource and shader resource view for directx, same RGBA layout as the software pixels
+	DXGI_FORMAT format{ DXGI_FORMAT_R8G8B8A8_UNORM };
+	D3D11_TEXTURE2D_DESC desc{};
+	desc.Width = texture.GetWidth();
+	desc.Height = texture.GetHeight();
+	desc.MipLevels = 1;
+	desc.ArraySize = 1;
+	desc.Format = format;
+	desc.SampleDesc.Count = 1;
+	desc.SampleDesc.Quality = 0;
+	desc.Usage = D3D11_USAGE_DEFAULT;
+	desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+	desc.CPUAccessFlags = 0;
+	desc.MiscFlags = 0;
+
+	const UINT pitch{ static_cast<UINT>(texture.GetWidth() * sizeof(uint32_t)) };
+	D3D11_SUBRESOURCE_DATA initData;
+	initData.pSysMem = texture.GetPixels();
+	initData.SysMemPitch = pitch;
+	initData.SysMemSlicePitch = static_cast<UINT>(texture.GetHeight()) * pitch;
+
+	HRESULT result = pDevice->CreateTexture2D(&desc, &initData, &m_pResource);
+	if(FAILED(result))
+	{
+		std::cout << "Error creating Texture2D\n";
+		assert(false);
+	}
+
+
+	D3D11_SHADER_RESOURCE_VIEW_DESC SRVDesc{};
+	SRVDesc.Format = format;
+	SRVDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+	SRVDesc.Texture2D.MipLevels = 1;
+
+	result = pDevice->CreateShaderResourceView(m_pResource, &SRVDesc, &m_pShaderResourceView);
+
+	if(FAILED(result))
+	{
+		std::cout << "Error creating Shader Resource View\n";
+		assert(false);
+	}
+
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+class Texture;
+
+// DirectX copy of a software Texture, for the shaders of the hardware rasterizer
+class HardwareTexture final
+{
+public:
+	~HardwareTexture();
+	HardwareTexture(const HardwareTexture&) = delete;
+	HardwareTexture& operator=(const HardwareTexture&) = delete;
+	HardwareTexture(HardwareTexture&&) = delete;
+	HardwareTexture& operator=(HardwareTexture&&) = delete;
+
+	static HardwareTexture* Create(ID3D11Device* pDevice, const Texture& texture);
+	ID3D11ShaderResourceView* GetShaderResourceView() const { return m_pShaderResourceView; };
+
+private:
+	HardwareTexture(ID3D11Device* pDevice, const Texture& texture);
+
+	ID3D11Texture2D* m_pResource{};
+	ID3D11ShaderResourceView* m_pShaderResourceView{};
+};
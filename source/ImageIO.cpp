@@ -0,0 +1,205 @@
+#include "ImageIO.h"
+#include "Texture.h"
+
+#include <cctype>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#if defined(DAE_HAS_PNG)
+#include <png.h>
+#endif
+
+namespace
+{
+	bool HasExtension(const std::string& path, const std::string& extension)
+	{
+		if(path.size() < extension.size())
+			return false;
+
+		for(size_t i{ 0 }; i < extension.size(); ++i)
+		{
+			if(std::tolower(static_cast<unsigned char>(path[path.size() - extension.size() + i])) != extension[i])
+				return false;
+		}
+		return true;
+	}
+
+	// Next header number, skips whitespace and # comments
+	bool ReadPPMNumber(std::istream& file, int& number)
+	{
+		while(file)
+		{
+			const int character{ file.peek() };
+			if(character == '#')
+				file.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+			else if(std::isspace(character))
+				file.get();
+			else
+				break;
+		}
+		return static_cast<bool>(file >> number);
+	}
+
+	Texture* LoadPPM(const std::string& path)
+	{
+		std::ifstream file{ path, std::ios::binary };
+		if(!file)
+			return nullptr;
+
+		char magic[2]{};
+		file.read(magic, 2);
+		int width{}, height{}, maxValue{};
+		if(magic[0] != 'P' || magic[1] != '6' || !ReadPPMNumber(file, width) || !ReadPPMNumber(file, height) || !ReadPPMNumber(file, maxValue))
+			return nullptr;
+
+		// Only 8 bit channels
+		if(width <= 0 || height <= 0 || maxValue != 255)
+			return nullptr;
+		file.get();  // Single whitespace before the pixels
+
+		std::vector<uint8_t> rgb(size_t(width) * height * 3);
+		if(!file.read(reinterpret_cast<char*>(rgb.data()), rgb.size()))
+			return nullptr;
+
+		std::vector<uint32_t> pixels(size_t(width) * height);
+		for(size_t i{ 0 }; i < pixels.size(); ++i)
+			pixels[i] = rgb[i * 3] | (rgb[i * 3 + 1] << 8) | (rgb[i * 3 + 2] << 16) | 0xff000000u;
+
+		return Texture::Create(width, height, pixels.data());
+	}
+
+	bool SavePPM(const std::string& path, const uint32_t* pPixels, int width, int height, int pitch)
+	{
+		FILE* pFile{ std::fopen(path.c_str(), "wb") };
+		if(!pFile)
+			return false;
+
+		std::fprintf(pFile, "P6\n%d %d\n255\n", width, height);
+
+		std::vector<uint8_t> row(size_t(width) * 3);
+		bool isWritten{ true };
+		for(int y{ 0 }; y < height && isWritten; ++y)
+		{
+			const uint32_t* pRow{ pPixels + size_t(y) * pitch };
+			for(int x{ 0 }; x < width; ++x)
+			{
+				row[x * 3] = uint8_t(pRow[x]);
+				row[x * 3 + 1] = uint8_t(pRow[x] >> 8);
+				row[x * 3 + 2] = uint8_t(pRow[x] >> 16);
+			}
+			isWritten = std::fwrite(row.data(), 1, row.size(), pFile) == row.size();
+		}
+
+		return std::fclose(pFile) == 0 && isWritten;
+	}
+
+#if defined(DAE_HAS_PNG)
+	Texture* LoadPNG(const std::string& path)
+	{
+		png_image image{};
+		image.version = PNG_IMAGE_VERSION;
+		if(!png_image_begin_read_from_file(&image, path.c_str()))
+			return nullptr;
+
+		// Whatever is in the file, it comes out as RGBA
+		image.format = PNG_FORMAT_RGBA;
+		std::vector<uint32_t> pixels(size_t(image.width) * image.height);
+		if(!png_image_finish_read(&image, nullptr, pixels.data(), 0, nullptr))
+		{
+			png_image_free(&image);
+			return nullptr;
+		}
+
+		return Texture::Create(int(image.width), int(image.height), pixels.data());
+	}
+
+	bool SavePNG(const std::string& path, const uint32_t* pPixels, int width, int height, int pitch)
+	{
+		// Drop the alpha, rendered frames are opaque
+		std::vector<uint8_t> rgb(size_t(width) * height * 3);
+		for(int y{ 0 }; y < height; ++y)
+		{
+			const uint32_t* pRow{ pPixels + size_t(y) * pitch };
+			uint8_t* pOut{ rgb.data() + size_t(y) * width * 3 };
+			for(int x{ 0 }; x < width; ++x)
+			{
+				pOut[x * 3] = uint8_t(pRow[x]);
+				pOut[x * 3 + 1] = uint8_t(pRow[x] >> 8);
+				pOut[x * 3 + 2] = uint8_t(pRow[x] >> 16);
+			}
+		}
+
+		png_image image{};
+		image.version = PNG_IMAGE_VERSION;
+		image.width = png_uint_32(width);
+		image.height = png_uint_32(height);
+		image.format = PNG_FORMAT_RGB;
+		image.flags = PNG_IMAGE_FLAG_FAST;  // Bigger files, a lot less time in zlib
+
+		const bool isWritten{ png_image_write_to_file(&image, path.c_str(), 0, rgb.data(), 0, nullptr) != 0 };
+		png_image_free(&image);
+		return isWritten;
+	}
+#endif
+}
+
+namespace ImageIO
+{
+	bool IsSupported([[maybe_unused]] FileFormat format)
+	{
+#if defined(DAE_HAS_PNG)
+		return true;
+#else
+		return format == FileFormat::PPM;
+#endif
+	}
+
+	const char* GetExtension(FileFormat format)
+	{
+		return format == FileFormat::PNG ? ".png" : ".ppm";
+	}
+
+	Texture* LoadTexture(const std::string& path)
+	{
+		Texture* pTexture{ nullptr };
+		if(HasExtension(path, ".ppm"))
+			pTexture = LoadPPM(path);
+#if defined(DAE_HAS_PNG)
+		else if(HasExtension(path, ".png"))
+			pTexture = LoadPNG(path);
+#endif
+		else
+		{
+			std::cout << "ImageIO: unsupported texture format " << path << "\n";
+			return nullptr;
+		}
+
+		if(!pTexture)
+			std::cout << "ImageIO: could not load " << path << "\n";
+		return pTexture;
+	}
+
+	PixelPacking GetRGBAPacking()
+	{
+		return PixelPacking{ 0, 8, 16, 0xff000000u };
+	}
+
+	bool SaveImage(const std::string& path, FileFormat format, const uint32_t* pPixels, int width, int height, int pitch)
+	{
+		switch(format)
+		{
+			case FileFormat::PPM:
+				return SavePPM(path, pPixels, width, height, pitch);
+			case FileFormat::PNG:
+#if defined(DAE_HAS_PNG)
+				return SavePNG(path, pPixels, width, height, pitch);
+#else
+				return false;
+#endif
+		}
+		return false;
+	}
+}
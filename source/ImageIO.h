@@ -0,0 +1,29 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include "SoftwareRasterizer.h"
+
+class Texture;
+
+// Image files for the tools without SDL: textures in, rendered frames out
+// PNG needs libpng (DAE_HAS_PNG), binary PPM (P6) always works
+namespace ImageIO
+{
+	enum class FileFormat
+	{
+		PPM,
+		PNG
+	};
+
+	bool IsSupported(FileFormat format);
+	const char* GetExtension(FileFormat format);
+
+	// Picked from the extension: .png or .ppm, nullptr when it can't be read
+	Texture* LoadTexture(const std::string& path);
+
+	// Packing the frames have to be rendered with for SaveImage: RGBA in memory, red in the lowest byte
+	PixelPacking GetRGBAPacking();
+
+	// pPixels: width x height, pitch in pixels, laid out as GetRGBAPacking (alpha is dropped)
+	bool SaveImage(const std::string& path, FileFormat format, const uint32_t* pPixels, int width, int height, int pitch);
+}
@@ -0,0 +1,260 @@
+#include "JobSystem.h"
+#include "Profiler.h"
+
+#include <deque>
+#include <iostream>
+#include <thread>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace
+{
+	// Which worker of which job system the current thread is, -1 for every other thread
+	thread_local const JobSystem* t_pOwner{ nullptr };
+	thread_local int t_WorkerIndex{ -1 };
+}
+
+struct JobSystem::Worker
+{
+	std::thread thread{};
+	std::mutex queueMutex{};
+	std::deque<Job> queue{};
+	std::deque<Job> ownJobs{};  // Only this worker may run these (RunOnEachThread)
+};
+
+JobSystem::JobSystem(const JobSystemSettings& settings) :
+	m_Settings{ settings }
+{
+	int numWorkers{ settings.NumWorkers };
+	if(numWorkers < 0)
+		numWorkers = std::max(0, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+
+	if(m_Settings.ReserveMainCore && !PinCurrentThread(GetMainCore()))
+		std::cout << "JobSystem: could not pin the main thread to core " << GetMainCore() << "\n";
+
+	// Create all queues before any worker starts stealing from them
+	m_Workers.reserve(numWorkers);
+	for(int i{ 0 }; i < numWorkers; ++i)
+		m_Workers.push_back(new Worker{});
+
+	for(uint32_t i{ 0 }; i < m_Workers.size(); ++i)
+		m_Workers[i]->thread = std::thread{ &JobSystem::WorkerLoop, this, i };
+}
+
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock{ m_SleepMutex };
+		m_IsStopping = true;
+	}
+	m_WakeCondition.notify_all();
+
+	// Join them all before deleting any, a worker can still be looking through the other queues
+	for(Worker* pWorker : m_Workers)
+		pWorker->thread.join();
+
+	for(Worker* pWorker : m_Workers)
+		delete pWorker;
+	m_Workers.clear();
+}
+
+void JobSystem::Schedule(std::function<void()> function, std::atomic<uint32_t>* pPendingCounter, int preferredWorker)
+{
+	if(m_Workers.empty())
+	{
+		// Nobody to hand it to
+		function();
+		if(pPendingCounter)
+			pPendingCounter->fetch_sub(1, std::memory_order_release);
+		return;
+	}
+
+	// Workers push on their own queue (it stays hot in their cache), everyone else spreads the jobs over all queues
+	uint32_t queueIndex{};
+	if(preferredWorker >= 0)
+		queueIndex = static_cast<uint32_t>(preferredWorker) % GetNumWorkers();
+	else if(t_pOwner == this)
+		queueIndex = static_cast<uint32_t>(t_WorkerIndex);
+	else
+		queueIndex = m_NextQueue.fetch_add(1, std::memory_order_relaxed) % GetNumWorkers();
+
+	Worker* pWorker{ m_Workers[queueIndex] };
+	{
+		std::lock_guard<std::mutex> lock{ pWorker->queueMutex };
+		pWorker->queue.push_back(Job{ std::move(function), pPendingCounter });
+		m_NumQueuedJobs.fetch_add(1, std::memory_order_release);
+	}
+
+	WakeWorker();
+}
+
+uint32_t JobSystem::GetCurrentThreadIndex() const
+{
+	return t_pOwner == this ? static_cast<uint32_t>(t_WorkerIndex) : GetNumWorkers();
+}
+
+void JobSystem::RunOnEachThread(const std::function<void(uint32_t threadIndex)>& function)
+{
+	std::atomic<uint32_t> pendingJobs{ GetNumWorkers() };
+	for(uint32_t workerIndex{ 0 }; workerIndex < GetNumWorkers(); ++workerIndex)
+	{
+		Worker* pWorker{ m_Workers[workerIndex] };
+		std::lock_guard<std::mutex> lock{ pWorker->queueMutex };
+		pWorker->ownJobs.push_back(Job{ [&function, workerIndex]() { function(workerIndex); }, &pendingJobs });
+		m_NumQueuedJobs.fetch_add(1, std::memory_order_release);
+	}
+
+	// Every worker has to wake up for its own job, not just any
+	WakeAllWorkers();
+
+	function(GetNumWorkers());
+	Wait(pendingJobs);
+}
+
+void JobSystem::Wait(const std::atomic<uint32_t>& pendingCounter)
+{
+	// Help out instead of blocking, this is what keeps the calling thread busy and nested waits deadlock free
+	while(pendingCounter.load(std::memory_order_acquire) != 0)
+	{
+		if(!TryRunJob())
+			std::this_thread::yield();
+	}
+}
+
+void JobSystem::WorkerLoop(uint32_t workerIndex)
+{
+	t_pOwner = this;
+	t_WorkerIndex = static_cast<int>(workerIndex);
+	DAE_PROFILE_THREAD("Worker " + std::to_string(workerIndex));
+
+	if(m_Settings.PinWorkers && !PinCurrentThread(GetWorkerCore(workerIndex)))
+		std::cout << "JobSystem: could not pin worker " << workerIndex << " to core " << GetWorkerCore(workerIndex) << "\n";
+
+	while(!m_IsStopping.load(std::memory_order_acquire))
+	{
+		if(TryRunJob())
+			continue;
+
+		std::unique_lock<std::mutex> lock{ m_SleepMutex };
+		m_WakeCondition.wait(lock, [this]()
+		{
+			return m_IsStopping.load(std::memory_order_relaxed) || m_NumQueuedJobs.load(std::memory_order_acquire) != 0;
+		});
+	}
+}
+
+bool JobSystem::TryRunJob()
+{
+	Job job{};
+	if(!TryPopJob(job))
+		return false;
+
+	job.function();
+	job.function = nullptr;  // Release the captures before the owner is told the job is done
+
+	if(job.pPendingCounter)
+		job.pPendingCounter->fetch_sub(1, std::memory_order_release);
+
+	return true;
+}
+
+bool JobSystem::TryPopJob(Job& job)
+{
+	if(m_NumQueuedJobs.load(std::memory_order_acquire) == 0)
+		return false;
+
+	const uint32_t numWorkers{ GetNumWorkers() };
+	const bool isOwnWorker{ t_pOwner == this };
+
+	// Newest job of our own queue first, its data is most likely still in cache
+	if(isOwnWorker)
+	{
+		Worker* pWorker{ m_Workers[t_WorkerIndex] };
+		std::lock_guard<std::mutex> lock{ pWorker->queueMutex };
+		if(!pWorker->ownJobs.empty())
+		{
+			job = std::move(pWorker->ownJobs.front());
+			pWorker->ownJobs.pop_front();
+			m_NumQueuedJobs.fetch_sub(1, std::memory_order_relaxed);
+			return true;
+		}
+		if(!pWorker->queue.empty())
+		{
+			job = std::move(pWorker->queue.back());
+			pWorker->queue.pop_back();
+			m_NumQueuedJobs.fetch_sub(1, std::memory_order_relaxed);
+			return true;
+		}
+	}
+
+	// Steal the oldest job of another queue, old jobs tend to be the bigger ones
+	const uint32_t firstVictim{ isOwnWorker ? static_cast<uint32_t>(t_WorkerIndex) + 1 : 0 };
+	for(uint32_t i{ 0 }; i < numWorkers; ++i)
+	{
+		Worker* pVictim{ m_Workers[(firstVictim + i) % numWorkers] };
+		std::lock_guard<std::mutex> lock{ pVictim->queueMutex };
+		if(!pVictim->queue.empty())
+		{
+			job = std::move(pVictim->queue.front());
+			pVictim->queue.pop_front();
+			m_NumQueuedJobs.fetch_sub(1, std::memory_order_relaxed);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void JobSystem::WakeWorker()
+{
+	// Take the sleep lock so a worker cant check for jobs and go to sleep in between
+	{
+		std::lock_guard<std::mutex> lock{ m_SleepMutex };
+	}
+	m_WakeCondition.notify_one();
+}
+
+void JobSystem::WakeAllWorkers()
+{
+	{
+		std::lock_guard<std::mutex> lock{ m_SleepMutex };
+	}
+	m_WakeCondition.notify_all();
+}
+
+uint32_t JobSystem::GetMainCore() const
+{
+	const uint32_t numCores{ std::max(1u, std::thread::hardware_concurrency()) };
+	return static_cast<uint32_t>(std::max(0, m_Settings.FirstCore)) % numCores;
+}
+
+uint32_t JobSystem::GetWorkerCore(uint32_t workerIndex) const
+{
+	const uint32_t numCores{ std::max(1u, std::thread::hardware_concurrency()) };
+
+	// Skip the core of the main thread when it is reserved, wrap around when there are more workers than cores
+	if(m_Settings.ReserveMainCore && numCores > 1)
+		return (GetMainCore() + 1 + workerIndex % (numCores - 1)) % numCores;
+	return (GetMainCore() + workerIndex) % numCores;
+}
+
+bool JobSystem::PinCurrentThread(uint32_t core)
+{
+#if defined(_WIN32)
+	// Affinity masks only cover the 64 cores of the current processor group
+	if(core >= sizeof(DWORD_PTR) * 8)
+		return false;
+	return SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << core) != 0;
+#else
+	cpu_set_t cpuSet;
+	CPU_ZERO(&cpuSet);
+	CPU_SET(core, &cpuSet);
+	return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuSet) == 0;
+#endif
+}
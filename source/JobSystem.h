@@ -0,0 +1,156 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+// Thread setup of the job system
+struct JobSystemSettings
+{
+	// -1 = one worker per hardware thread, minus the calling thread (which helps out while waiting)
+	int NumWorkers{ -1 };
+
+	// Pin every worker to its own core so it never migrates (and keeps the memory it first touched on its own NUMA node)
+	bool PinWorkers{ false };
+
+	// Keep core 0 (or FirstCore) for the calling (main / event) thread: the calling thread gets pinned there and no worker uses it
+	bool ReserveMainCore{ false };
+
+	// Core the pinned threads start counting from, instead of 0, so several job systems can each get cores of their own
+	int FirstCore{ 0 };
+};
+
+// Work stealing scheduler with persistent worker threads
+// Every worker owns a deque: it takes its own jobs from the back, idle workers steal from the front of the others.
+// Threads that wait on work (also the main thread) run queued jobs while waiting instead of blocking.
+class JobSystem final
+{
+public:
+	explicit JobSystem(const JobSystemSettings& settings = {});
+
+	~JobSystem();
+	JobSystem(const JobSystem&) = delete;
+	JobSystem& operator=(const JobSystem&) = delete;
+	JobSystem(JobSystem&&) = delete;
+	JobSystem& operator=(JobSystem&&) = delete;
+
+	uint32_t GetNumWorkers() const { return static_cast<uint32_t>(m_Workers.size()); };
+	// Workers + the thread that waits on the work
+	uint32_t GetNumThreads() const { return GetNumWorkers() + 1; };
+	// 0 to GetNumWorkers() - 1 on a worker of this job system, GetNumWorkers() on any other thread (the one waiting on the work)
+	uint32_t GetCurrentThreadIndex() const;
+
+	// Calls function(index) for every index in [begin, end), split in chunks of grainSize indices
+	// grainSize 0 picks a chunk size that gives every thread a few chunks to balance with
+	template<typename Function>
+	void ParallelFor(uint32_t begin, uint32_t end, const Function& function, uint32_t grainSize = 0);
+
+	// Queues a job, pendingCounter gets decremented once it finished (increment it before calling this)
+	// preferredWorker puts the job in the queue of that worker (others can still steal it when idle), -1 = no preference
+	void Schedule(std::function<void()> function, std::atomic<uint32_t>* pPendingCounter, int preferredWorker = -1);
+
+	// Runs queued jobs until the counter reaches 0
+	void Wait(const std::atomic<uint32_t>& pendingCounter);
+
+	// Calls function(threadIndex) exactly once on every worker (0 to GetNumWorkers() - 1) and once on the calling thread (GetNumWorkers())
+	// These jobs are never stolen, use it to give each thread its own part of a buffer (first touch, per thread data)
+	void RunOnEachThread(const std::function<void(uint32_t threadIndex)>& function);
+
+	const JobSystemSettings& GetSettings() const { return m_Settings; };
+
+private:
+	struct Job
+	{
+		std::function<void()> function{};
+		std::atomic<uint32_t>* pPendingCounter{ nullptr };
+	};
+	struct Worker;
+
+	JobSystemSettings m_Settings{};
+	std::vector<Worker*> m_Workers{};
+
+	std::atomic<uint32_t> m_NumQueuedJobs{ 0 };
+	std::atomic<uint32_t> m_NextQueue{ 0 };  // Round robin queue for jobs scheduled from outside the workers
+	std::atomic<bool> m_IsStopping{ false };
+
+	// Workers sleep here when no queue has work
+	std::mutex m_SleepMutex{};
+	std::condition_variable m_WakeCondition{};
+
+	void WorkerLoop(uint32_t workerIndex);
+	bool TryRunJob();
+	bool TryPopJob(Job& job);
+	void WakeWorker();
+	void WakeAllWorkers();
+
+	// Cores the workers and the calling thread get pinned to
+	uint32_t GetMainCore() const;
+	uint32_t GetWorkerCore(uint32_t workerIndex) const;
+	static bool PinCurrentThread(uint32_t core);
+};
+
+// Jobs that belong together, Wait returns once all of them finished
+class TaskGroup final
+{
+public:
+	explicit TaskGroup(JobSystem& jobSystem) : m_JobSystem{ jobSystem } {};
+
+	// Never leave jobs running that might reference the group
+	~TaskGroup() { Wait(); };
+	TaskGroup(const TaskGroup&) = delete;
+	TaskGroup& operator=(const TaskGroup&) = delete;
+	TaskGroup(TaskGroup&&) = delete;
+	TaskGroup& operator=(TaskGroup&&) = delete;
+
+	void Run(std::function<void()> function)
+	{
+		m_PendingTasks.fetch_add(1, std::memory_order_relaxed);
+		m_JobSystem.Schedule(std::move(function), &m_PendingTasks);
+	}
+
+	void Wait() { m_JobSystem.Wait(m_PendingTasks); };
+
+private:
+	JobSystem& m_JobSystem;
+	std::atomic<uint32_t> m_PendingTasks{ 0 };
+};
+
+template<typename Function>
+void JobSystem::ParallelFor(uint32_t begin, uint32_t end, const Function& function, uint32_t grainSize)
+{
+	if(begin >= end)
+		return;
+
+	const uint32_t count{ end - begin };
+	if(grainSize == 0)
+		grainSize = std::max(1u, count / (GetNumThreads() * 4));
+
+	// Not worth splitting up (or nobody to split with), run it right here
+	if(count <= grainSize || m_Workers.empty())
+	{
+		for(uint32_t index{ begin }; index < end; ++index)
+			function(index);
+		return;
+	}
+
+	std::atomic<uint32_t> pendingChunks{ 0 };
+	uint32_t chunkBegin{ begin };
+	while(chunkBegin < end)
+	{
+		const uint32_t chunkEnd{ chunkBegin + std::min(grainSize, end - chunkBegin) };
+
+		pendingChunks.fetch_add(1, std::memory_order_relaxed);
+		Schedule([&function, chunkBegin, chunkEnd]()
+		{
+			for(uint32_t index{ chunkBegin }; index < chunkEnd; ++index)
+				function(index);
+		}, &pendingChunks);
+
+		chunkBegin = chunkEnd;
+	}
+
+	Wait(pendingChunks);
+}
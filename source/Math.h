@@ -4,4 +4,10 @@
 #include "Vector3.h"
 #include "Vector4.h"
 #include "Matrix.h"
-#include "MathHelpers.h"
\ No newline at end of file
+#include "MathHelpers.h"
+
+// SoA packets for the software rasterizer (one pixel per lane)
+#include "Floatx4.h"
+#include "Vector2x4.h"
+#include "Vector3x4.h"
+#include "ColorRGBx4.h"
\ No newline at end of file
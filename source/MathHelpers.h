@@ -1,5 +1,13 @@
 #pragma once
 #include <cmath>
+#include <cfloat>
+
+// Hot math (operators, Dot, Cross, transforms) is forced inline, the raster and vertex loops call it per pixel / vertex
+#if defined(_MSC_VER)
+#define DAE_FORCEINLINE __forceinline
+#else
+#define DAE_FORCEINLINE inline __attribute__((always_inline))
+#endif
 
 namespace dae
 {
@@ -21,29 +29,30 @@ namespace dae
 	constexpr auto TO_RADIANS(PI / 180.0f);
 
 	/* --- HELPER FUNCTIONS --- */
-	inline float Square(float a)
+	constexpr float Square(float a)
 	{
 		return a * a;
 	}
 
-	inline float Lerpf(float a, float b, float factor)
+	constexpr float Lerpf(float a, float b, float factor)
 	{
 		return ((1 - factor) * a) + (factor * b);
 	}
 
-	inline bool AreEqual(float a, float b, float epsilon = FLT_EPSILON)
+	constexpr bool AreEqual(float a, float b, float epsilon = FLT_EPSILON)
 	{
-		return abs(a - b) < epsilon;
+		// Written without abs to stay usable in constant expressions
+		return (a - b) < epsilon && (b - a) < epsilon;
 	}
 
-	inline int Clamp(const int v, int min, int max)
+	constexpr int Clamp(const int v, int min, int max)
 	{
 		if (v < min) return min;
 		if (v > max) return max;
 		return v;
 	}
 
-	inline float Clamp(const float v, float min, float max)
+	constexpr float Clamp(const float v, float min, float max)
 	{
 		if (v < min) return min;
 		if (v > max) return max;
@@ -63,7 +72,7 @@ namespace dae
 		return lowerBound + fmod(input - lowerBound, range);
 	}
 
-	inline float Saturate(const float v)
+	constexpr float Saturate(const float v)
 	{
 		if (v < 0.f) return 0.f;
 		if (v > 1.f) return 1.f;
@@ -1,65 +1,349 @@
 #pragma once
+#include <cassert>
+#include <type_traits>
+#include <xmmintrin.h>
+#include "MathHelpers.h"
 #include "Vector3.h"
 #include "Vector4.h"
 
 namespace dae {
 	struct Matrix
 	{
-		Matrix() = default;
-		Matrix(
+		constexpr Matrix() = default;
+		constexpr Matrix(
 			const Vector3& xAxis,
 			const Vector3& yAxis,
 			const Vector3& zAxis,
-			const Vector3& t);
+			const Vector3& t) :
+			Matrix({ xAxis, 0 }, { yAxis, 0 }, { zAxis, 0 }, { t, 1 })
+		{
+		}
 
-		Matrix(
+		constexpr Matrix(
 			const Vector4& xAxis,
 			const Vector4& yAxis,
 			const Vector4& zAxis,
-			const Vector4& t);
-
-		Matrix(const Matrix& m);
-
-		Vector3 TransformVector(const Vector3& v) const;
-		Vector3 TransformVector(float x, float y, float z) const;
-		Vector3 TransformPoint(const Vector3& p) const;
-		Vector3 TransformPoint(float x, float y, float z) const;
-
-		Vector4 TransformPoint(const Vector4& p) const;
-		Vector4 TransformPoint(float x, float y, float z, float w) const;
-
-		const Matrix& Transpose();
-		const Matrix& Inverse();
-
-		Vector3 GetAxisX() const;
-		Vector3 GetAxisY() const;
-		Vector3 GetAxisZ() const;
-		Vector3 GetTranslation() const;
-
-		static Matrix CreateTranslation(float x, float y, float z);
-		static Matrix CreateTranslation(const Vector3& t);
-		static Matrix CreateRotationX(float pitch);
-		static Matrix CreateRotationY(float yaw);
-		static Matrix CreateRotationZ(float roll);
-		static Matrix CreateRotation(float pitch, float yaw, float roll);
-		static Matrix CreateRotation(const Vector3& r);
-		static Matrix CreateScale(float sx, float sy, float sz);
-		static Matrix CreateScale(const Vector3& s);
-		static Matrix Transpose(const Matrix& m);
-		static Matrix Inverse(const Matrix& m);
-
-		static Matrix CreateLookAtLH(const Vector3& origin, const Vector3& forward, const Vector3& up);
-		static Matrix CreatePerspectiveFovLH(float fovy, float aspect, float zn, float zf);
-
-		Vector4& operator[](int index);
-		Vector4 operator[](int index) const;
-		Matrix operator*(const Matrix& m) const;
-		const Matrix& operator*=(const Matrix& m);
+			const Vector4& t) :
+			data{ xAxis, yAxis, zAxis, t }
+		{
+		}
+
+		// No user copy constructor, keeps Matrix trivially copyable
+
+		DAE_FORCEINLINE constexpr Vector3 TransformVector(const Vector3& v) const
+		{
+			return TransformVector(v.x, v.y, v.z);
+		}
+
+		DAE_FORCEINLINE constexpr Vector3 TransformVector(float x, float y, float z) const
+		{
+			return Vector3{
+				data[0].x * x + data[1].x * y + data[2].x * z,
+				data[0].y * x + data[1].y * y + data[2].y * z,
+				data[0].z * x + data[1].z * y + data[2].z * z
+			};
+		}
+
+		DAE_FORCEINLINE constexpr Vector3 TransformPoint(const Vector3& p) const
+		{
+			return TransformPoint(p.x, p.y, p.z);
+		}
+
+		DAE_FORCEINLINE constexpr Vector3 TransformPoint(float x, float y, float z) const
+		{
+			return Vector3{
+				data[0].x * x + data[1].x * y + data[2].x * z + data[3].x,
+				data[0].y * x + data[1].y * y + data[2].y * z + data[3].y,
+				data[0].z * x + data[1].z * y + data[2].z * z + data[3].z,
+			};
+		}
+
+		DAE_FORCEINLINE constexpr Vector4 TransformPoint(const Vector4& p) const
+		{
+			return TransformPoint(p.x, p.y, p.z, p.w);
+		}
+
+		DAE_FORCEINLINE constexpr Vector4 TransformPoint(float x, float y, float z, float w) const
+		{
+			return Vector4{
+				data[0].x * x + data[1].x * y + data[2].x * z + data[3].x,
+				data[0].y * x + data[1].y * y + data[2].y * z + data[3].y,
+				data[0].z * x + data[1].z * y + data[2].z * z + data[3].z,
+				data[0].w * x + data[1].w * y + data[2].w * z + data[3].w
+			};
+		}
+
+		constexpr const Matrix& Transpose()
+		{
+			Matrix result{};
+			for (int r{ 0 }; r < 4; ++r)
+			{
+				for (int c{ 0 }; c < 4; ++c)
+				{
+					result[r][c] = data[c][r];
+				}
+			}
+
+			data[0] = result[0];
+			data[1] = result[1];
+			data[2] = result[2];
+			data[3] = result[3];
+
+			return *this;
+		}
+
+		constexpr const Matrix& Inverse()
+		{
+			if (!std::is_constant_evaluated())
+			{
+				InverseSSE();
+				return *this;
+			}
+
+			//Optimized Inverse as explained in FGED1 - used widely in other libraries too.
+			const Vector3 a{ data[0] };
+			const Vector3 b{ data[1] };
+			const Vector3 c{ data[2] };
+			const Vector3 d{ data[3] };
+
+			const float x = data[0][3];
+			const float y = data[1][3];
+			const float z = data[2][3];
+			const float w = data[3][3];
+
+			Vector3 s = Vector3::Cross(a, b);
+			Vector3 t = Vector3::Cross(c, d);
+			Vector3 u = a * y - b * x;
+			Vector3 v = c * w - d * z;
+
+			const float det = Vector3::Dot(s, v) + Vector3::Dot(t, u);
+			assert((!AreEqual(det, 0.f)) && "ERROR: determinant is 0, there is no INVERSE!");
+			const float invDet = 1.f / det;
+
+			s *= invDet; t *= invDet; u *= invDet; v *= invDet;
+
+			const Vector3 r0 = Vector3::Cross(b, v) + t * y;
+			const Vector3 r1 = Vector3::Cross(v, a) - t * x;
+			const Vector3 r2 = Vector3::Cross(d, u) + s * w;
+			//Vector3 r3 = Vector3::Cross(u, c) - s * z;
+
+			data[0] = Vector4{ r0.x, r1.x, r2.x, 0.f };
+			data[1] = Vector4{ r0.y, r1.y, r2.y, 0.f };
+			data[2] = Vector4{ r0.z, r1.z, r2.z, 0.f };
+			data[3] = { -Vector3::Dot(b, t),Vector3::Dot(a, t),-Vector3::Dot(d, s),Vector3::Dot(c, s) };
+
+			return *this;
+		}
+
+		constexpr Vector3 GetAxisX() const
+		{
+			return data[0];
+		}
+
+		constexpr Vector3 GetAxisY() const
+		{
+			return data[1];
+		}
+
+		constexpr Vector3 GetAxisZ() const
+		{
+			return data[2];
+		}
+
+		constexpr Vector3 GetTranslation() const
+		{
+			return data[3];
+		}
+
+		static constexpr Matrix CreateTranslation(float x, float y, float z)
+		{
+			return CreateTranslation({ x, y, z });
+		}
+
+		static constexpr Matrix CreateTranslation(const Vector3& t)
+		{
+			return { Vector3::UnitX, Vector3::UnitY, Vector3::UnitZ, t };
+		}
+
+		static Matrix CreateRotationX(float pitch)
+		{
+			return {
+				{1, 0, 0, 0},
+				{0, cosf(pitch), -sinf(pitch), 0},
+				{0, sinf(pitch), cosf(pitch), 0},
+				{0, 0, 0, 1}
+			};
+		}
+
+		static Matrix CreateRotationY(float yaw)
+		{
+			return {
+				{cosf(yaw), 0, -sinf(yaw), 0},
+				{0, 1, 0, 0},
+				{sinf(yaw), 0, cosf(yaw), 0},
+				{0, 0, 0, 1}
+			};
+		}
+
+		static Matrix CreateRotationZ(float roll)
+		{
+			return {
+				{cosf(roll), sinf(roll), 0, 0},
+				{-sinf(roll), cosf(roll), 0, 0},
+				{0, 0, 1, 0},
+				{0, 0, 0, 1}
+			};
+		}
+
+		static Matrix CreateRotation(float pitch, float yaw, float roll)
+		{
+			return CreateRotation({ pitch, yaw, roll });
+		}
+
+		static Matrix CreateRotation(const Vector3& r)
+		{
+			return CreateRotationX(r[0]) * CreateRotationY(r[1]) * CreateRotationZ(r[2]);
+		}
+
+		static constexpr Matrix CreateScale(float sx, float sy, float sz)
+		{
+			return { Vector3{ sx, 0, 0 }, Vector3{ 0, sy, 0 }, Vector3{ 0, 0, sz }, Vector3::Zero };
+		}
+
+		static constexpr Matrix CreateScale(const Vector3& s)
+		{
+			return CreateScale(s[0], s[1], s[2]);
+		}
+
+		static constexpr Matrix Transpose(const Matrix& m)
+		{
+			Matrix out{ m };
+			out.Transpose();
+
+			return out;
+		}
+
+		static constexpr Matrix Inverse(const Matrix& m)
+		{
+			Matrix out{ m };
+			out.Inverse();
+
+			return out;
+		}
+
+		// Inverse of a rotation + translation matrix (orthonormal axes, no scale)
+		// The rotation part is transposed, the translation is rotated back and negated
+		static constexpr Matrix InverseRigid(const Matrix& m)
+		{
+			const Vector3 x{ m.data[0] };
+			const Vector3 y{ m.data[1] };
+			const Vector3 z{ m.data[2] };
+			const Vector3 t{ m.data[3] };
+
+			return {
+				Vector4{ x.x, y.x, z.x, 0.f },
+				Vector4{ x.y, y.y, z.y, 0.f },
+				Vector4{ x.z, y.z, z.z, 0.f },
+				Vector4{ -Vector3::Dot(t, x), -Vector3::Dot(t, y), -Vector3::Dot(t, z), 1.f }
+			};
+		}
+
+		// Inverse of any matrix with a last column of (0, 0, 0, 1): rotation, (non-uniform) scale, shear and translation
+		// Only a 3x3 inverse is needed, the translation follows from it
+		static constexpr Matrix InverseAffine(const Matrix& m)
+		{
+			const Vector3 x{ m.data[0] };
+			const Vector3 y{ m.data[1] };
+			const Vector3 z{ m.data[2] };
+			const Vector3 t{ m.data[3] };
+
+			// Columns of the inverse are the cross products of the axes, divided by the determinant
+			const Vector3 yz{ Vector3::Cross(y, z) };
+			const Vector3 zx{ Vector3::Cross(z, x) };
+			const Vector3 xy{ Vector3::Cross(x, y) };
+
+			const float det{ Vector3::Dot(x, yz) };
+			assert((!AreEqual(det, 0.f)) && "ERROR: determinant is 0, there is no INVERSE!");
+			const float invDet{ 1.f / det };
+
+			const Vector3 c0{ yz * invDet };
+			const Vector3 c1{ zx * invDet };
+			const Vector3 c2{ xy * invDet };
+
+			return {
+				Vector4{ c0.x, c1.x, c2.x, 0.f },
+				Vector4{ c0.y, c1.y, c2.y, 0.f },
+				Vector4{ c0.z, c1.z, c2.z, 0.f },
+				Vector4{ -Vector3::Dot(t, c0), -Vector3::Dot(t, c1), -Vector3::Dot(t, c2), 1.f }
+			};
+		}
+
+		static Matrix CreateLookAtLH(const Vector3& origin, const Vector3& forward, const Vector3& up)
+		{
+			const Vector3 right = Vector3::Cross(Vector3::UnitY, forward).Normalized();
+			return {
+				Vector4(right, 0),
+				Vector4(up, 0),
+				Vector4(forward, 0),
+				Vector4(origin, 1)
+			};
+		}
+
+		static constexpr Matrix CreatePerspectiveFovLH(float fov, float aspect, float zn, float zf)
+		{
+			return {
+				{ 1.0f / (aspect * fov),	0.0f,		0.0f,					0.0f },
+				{ 0.0f,						1.0f / fov,	0.0f,					0.0f },
+				{ 0.0f,						0.0f,		zf / (zf - zn),			1.0f },
+				{ 0.0f,						0.0f,		-(zf * zn) / (zf - zn),	0.0f }
+			};
+		}
+
+#pragma region Operator Overloads
+		constexpr Vector4& operator[](int index)
+		{
+			assert(index <= 3 && index >= 0);
+			return data[index];
+		}
+
+		constexpr Vector4 operator[](int index) const
+		{
+			assert(index <= 3 && index >= 0);
+			return data[index];
+		}
+
+		DAE_FORCEINLINE constexpr Matrix operator*(const Matrix& m) const
+		{
+			if (!std::is_constant_evaluated())
+			{
+				return MultiplySSE(m);
+			}
+
+			// Row r of the result is row r of this matrix combined with the rows of m
+			Matrix result{};
+			for (int r{ 0 }; r < 4; ++r)
+			{
+				result.data[r] =
+					m.data[0] * data[r].x +
+					m.data[1] * data[r].y +
+					m.data[2] * data[r].z +
+					m.data[3] * data[r].w;
+			}
+
+			return result;
+		}
+
+		constexpr const Matrix& operator*=(const Matrix& m)
+		{
+			*this = *this * m;
+			return *this;
+		}
+#pragma endregion
 
 	private:
 
-		//Row-Major Matrix
-		Vector4 data[4]
+		//Row-Major Matrix, aligned so every row loads straight into an SSE register
+		alignas(16) Vector4 data[4]
 		{
 			{1,0,0,0}, //xAxis
 			{0,1,0,0}, //yAxis
@@ -71,5 +355,119 @@ namespace dae {
 		// v1x v1y v1z v1w
 		// v2x v2y v2z v2w
 		// v3x v3y v3z v3w
+
+#pragma region SSE
+		// Runtime paths of operator* and Inverse, the scalar versions above stay for constant evaluation
+		__m128 LoadRow(int index) const { return _mm_load_ps(&data[index].x); }
+		void StoreRow(int index, __m128 row) { _mm_store_ps(&data[index].x, row); }
+
+		template<int x, int y, int z, int w>
+		static DAE_FORCEINLINE __m128 Shuffle(__m128 a, __m128 b)
+		{
+			return _mm_shuffle_ps(a, b, _MM_SHUFFLE(w, z, y, x));
+		}
+
+		template<int x, int y, int z, int w>
+		static DAE_FORCEINLINE __m128 Swizzle(__m128 v)
+		{
+			return Shuffle<x, y, z, w>(v, v);
+		}
+
+		DAE_FORCEINLINE Matrix MultiplySSE(const Matrix& m) const
+		{
+			const __m128 m0{ m.LoadRow(0) };
+			const __m128 m1{ m.LoadRow(1) };
+			const __m128 m2{ m.LoadRow(2) };
+			const __m128 m3{ m.LoadRow(3) };
+
+			Matrix result{};
+			for (int r{ 0 }; r < 4; ++r)
+			{
+				const __m128 row{ LoadRow(r) };
+				__m128 sum{ _mm_mul_ps(Swizzle<0, 0, 0, 0>(row), m0) };
+				sum = _mm_add_ps(sum, _mm_mul_ps(Swizzle<1, 1, 1, 1>(row), m1));
+				sum = _mm_add_ps(sum, _mm_mul_ps(Swizzle<2, 2, 2, 2>(row), m2));
+				sum = _mm_add_ps(sum, _mm_mul_ps(Swizzle<3, 3, 3, 3>(row), m3));
+				result.StoreRow(r, sum);
+			}
+
+			return result;
+		}
+
+		// 2x2 blocks stored row-major in one register: (a, b, c, d) = | a b |
+		//                                                           | c d |
+		// A * B
+		static DAE_FORCEINLINE __m128 Mat2Mul(__m128 a, __m128 b)
+		{
+			return _mm_add_ps(_mm_mul_ps(a, Swizzle<0, 3, 0, 3>(b)),
+				_mm_mul_ps(Swizzle<1, 0, 3, 2>(a), Swizzle<2, 1, 2, 1>(b)));
+		}
+
+		// adjugate(A) * B
+		static DAE_FORCEINLINE __m128 Mat2AdjMul(__m128 a, __m128 b)
+		{
+			return _mm_sub_ps(_mm_mul_ps(Swizzle<3, 3, 0, 0>(a), b),
+				_mm_mul_ps(Swizzle<1, 1, 2, 2>(a), Swizzle<2, 3, 0, 1>(b)));
+		}
+
+		// A * adjugate(B)
+		static DAE_FORCEINLINE __m128 Mat2MulAdj(__m128 a, __m128 b)
+		{
+			return _mm_sub_ps(_mm_mul_ps(a, Swizzle<3, 0, 3, 0>(b)),
+				_mm_mul_ps(Swizzle<1, 0, 3, 2>(a), Swizzle<2, 1, 2, 1>(b)));
+		}
+
+		// General inverse through 2x2 sub matrices:
+		// | A B |^-1
+		// | C D |
+		void InverseSSE()
+		{
+			const __m128 row0{ LoadRow(0) };
+			const __m128 row1{ LoadRow(1) };
+			const __m128 row2{ LoadRow(2) };
+			const __m128 row3{ LoadRow(3) };
+
+			const __m128 a{ _mm_movelh_ps(row0, row1) };
+			const __m128 b{ _mm_movehl_ps(row1, row0) };
+			const __m128 c{ _mm_movelh_ps(row2, row3) };
+			const __m128 d{ _mm_movehl_ps(row3, row2) };
+
+			// Determinants of A, B, C and D in one go
+			const __m128 detSub{ _mm_sub_ps(
+				_mm_mul_ps(Shuffle<0, 2, 0, 2>(row0, row2), Shuffle<1, 3, 1, 3>(row1, row3)),
+				_mm_mul_ps(Shuffle<1, 3, 1, 3>(row0, row2), Shuffle<0, 2, 0, 2>(row1, row3))) };
+			const __m128 detA{ Swizzle<0, 0, 0, 0>(detSub) };
+			const __m128 detB{ Swizzle<1, 1, 1, 1>(detSub) };
+			const __m128 detC{ Swizzle<2, 2, 2, 2>(detSub) };
+			const __m128 detD{ Swizzle<3, 3, 3, 3>(detSub) };
+
+			const __m128 dc{ Mat2AdjMul(d, c) };
+			const __m128 ab{ Mat2AdjMul(a, b) };
+
+			__m128 x{ _mm_sub_ps(_mm_mul_ps(detD, a), Mat2Mul(b, dc)) };
+			__m128 w{ _mm_sub_ps(_mm_mul_ps(detA, d), Mat2Mul(c, ab)) };
+			__m128 y{ _mm_sub_ps(_mm_mul_ps(detB, c), Mat2MulAdj(d, ab)) };
+			__m128 z{ _mm_sub_ps(_mm_mul_ps(detC, b), Mat2MulAdj(a, dc)) };
+
+			// det(M) = det(A)det(D) + det(B)det(C) - trace(adj(A)B * adj(D)C)
+			__m128 trace{ _mm_mul_ps(ab, Swizzle<0, 2, 1, 3>(dc)) };
+			trace = _mm_add_ps(trace, Swizzle<2, 3, 0, 1>(trace));
+			trace = _mm_add_ps(trace, Swizzle<1, 0, 3, 2>(trace));
+
+			const __m128 det{ _mm_sub_ps(_mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC)), trace) };
+			assert((!AreEqual(_mm_cvtss_f32(det), 0.f)) && "ERROR: determinant is 0, there is no INVERSE!");
+
+			const __m128 invDet{ _mm_div_ps(_mm_setr_ps(1.f, -1.f, -1.f, 1.f), det) };
+			x = _mm_mul_ps(x, invDet);
+			y = _mm_mul_ps(y, invDet);
+			z = _mm_mul_ps(z, invDet);
+			w = _mm_mul_ps(w, invDet);
+
+			StoreRow(0, Shuffle<3, 1, 3, 1>(x, y));
+			StoreRow(1, Shuffle<2, 0, 2, 0>(x, y));
+			StoreRow(2, Shuffle<3, 1, 3, 1>(z, w));
+			StoreRow(3, Shuffle<2, 0, 2, 0>(z, w));
+		}
+#pragma endregion
 	};
-}
\ No newline at end of file
+}
@@ -1,7 +1,9 @@
 #pragma once
 #include "MathHelpers.h"
+#include <algorithm>
+#include <cstdint>
 #include <vector>
-#include "EffectVehicle.h"
+#include "Transform.h"
 
 using namespace dae;
 
@@ -31,56 +33,73 @@ struct Vertex_Out
 	Vector3 viewDirection{};
 };
 
+// Interpolated attributes of 4 pixels (one per lane), software only
+struct Vertex_Outx4
+{
+	Vector2x4 uv{};
+	Vector3x4 normal{};
+	Vector3x4 tangent{};
+	Vector3x4 viewDirection{};
+};
+
 enum class PrimitiveTopology
 {
 	TriangleList,
 	TriangleStrip
 };
 
+// Textures the software pixel shader samples, not owned by the mesh
+struct SoftwareMaterial
+{
+	const Texture* pDiffuseMap{ nullptr };
+	const Texture* pNormalMap{ nullptr };
+	const Texture* pSpecularMap{ nullptr };
+	const Texture* pGlossinessMap{ nullptr };
+};
+
 
 class Mesh final
 {
 public:
-	Mesh(ID3D11Device* pDevice, Effect* pEffect, const std::vector<Vertex>& _vertices, const std::vector<uint32_t> _indices, const Vector3& position = {});
+	// Geometry + transform, the DirectX buffers of the hardware rasterizer live in HardwareMesh
+	Mesh(const std::vector<Vertex>& _vertices, const std::vector<uint32_t>& _indices, const Vector3& position = {});
 
-	~Mesh();
+	~Mesh() = default;
 	Mesh(const Mesh&) = delete;
 	Mesh& operator=(const Mesh&) = delete;
 	Mesh(Mesh&&) = delete;
 	Mesh& operator=(Mesh&&) = delete;
 
-	void Render(ID3D11DeviceContext* pDeviceContext, Matrix worldViewProjMatrix, Matrix viewInverseMatrix);
-
-	Effect* GetEffect() const { return m_pEffect; }
+	void SetMaterial(const SoftwareMaterial& material) { m_Material = material; };
+	const SoftwareMaterial& GetMaterial() const { return m_Material; };
 
-	Matrix GetWorldMatrix() const { return m_ScaleTransform * m_RotationTransform * m_TranslationTransform; };
+	const Matrix& GetWorldMatrix() const { return m_Transform.GetWorldMatrix(); };
+	const Matrix& GetNormalMatrix() const { return m_Transform.GetNormalMatrix(); };
+	Transform& GetTransform() { return m_Transform; };
+	const Transform& GetTransform() const { return m_Transform; };
 	PrimitiveTopology GetTopology() const { return m_PrimitiveTopology; };
 
 	//void SetWorldMatrix(const Matrix& worldMatrix) { m_WorldMatrix = worldMatrix; };
 
 	void Translate(const Vector3& translation)
 	{
-		// *= For additive translation
-		m_TranslationTransform *= Matrix::CreateTranslation(translation);
+		m_Transform.Translate(translation);
 	}
 
 
 	void RotateX(float pitch)
 	{
-		// *= For additive rotation
-		m_RotationTransform *= Matrix::CreateRotationX(pitch);
+		m_Transform.Rotate(Quaternion::CreateRotationX(pitch));
 	}
 
 	void RotateY(float yaw)
 	{
-		// *= For additive rotation
-		m_RotationTransform *= Matrix::CreateRotationY(yaw);
+		m_Transform.Rotate(Quaternion::CreateRotationY(yaw));
 	}
 
 	void RotateZ(float roll)
 	{
-		// *= For additive rotation
-		m_RotationTransform *= Matrix::CreateRotationZ(roll);
+		m_Transform.Rotate(Quaternion::CreateRotationZ(roll));
 	}
 
 	void Scale(float uniformScale)
@@ -90,42 +109,40 @@ public:
 
 	void Scale(const Vector3& scale)
 	{
-		// *= For multiplicative scaling
-		m_ScaleTransform *= Matrix::CreateScale(scale);
+		m_Transform.Scale(scale);
 	}
 
 	// Software -------------------------------
 	// Public for easy access
 	std::vector<Vertex> vertices{};
 	std::vector<uint32_t> indices{};
-	std::vector<Vertex_Out> vertices_out{};
 
 
 	void SetVisibility(bool _visible) { m_Visible = _visible; };
 	bool Visible() const { return m_Visible; };
 
+	// World space bounding sphere, for frustum culling
+	Vector3 GetWorldBoundingCenter() const { return GetWorldMatrix().TransformPoint(m_BoundingCenter); };
+	float GetWorldBoundingRadius() const
+	{
+		const Vector3& scale{ m_Transform.GetScale() };
+		return m_BoundingRadius * std::max(std::abs(scale.x), std::max(std::abs(scale.y), std::abs(scale.z)));
+	};
+
 private:
 	// Shared ---------------------------------
 	PrimitiveTopology m_PrimitiveTopology{ PrimitiveTopology::TriangleList };
 	bool m_Visible{ true };  // Enables disables rendering
 
-	// Hardware -------------------------------
-	Effect* m_pEffect;
-
-	ID3DX11EffectTechnique* m_pTechnique;
-
-	ID3D11InputLayout* m_pInputLayout;
-
-	ID3D11Buffer* m_pVertexBuffer;
-	ID3D11Buffer* m_pIndexBuffer;
-
-	uint32_t m_NumIndices;
+	// Object space bounding sphere around all vertices
+	Vector3 m_BoundingCenter{};
+	float m_BoundingRadius{};
 
+	// Software -------------------------------
+	SoftwareMaterial m_Material{};
 
-	// These 3 together form the worldmatrix
-	Matrix m_RotationTransform{};
-	Matrix m_TranslationTransform{};
-	Matrix m_ScaleTransform{};
+	// Position, rotation and scale, caches the world matrix
+	Transform m_Transform{};
 
 
 };
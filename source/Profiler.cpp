@@ -0,0 +1,199 @@
+#include "Profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#define DAE_HAS_RDTSC
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define DAE_HAS_RDTSC
+#endif
+
+namespace
+{
+	struct ProfileEvent
+	{
+		const char* name;
+		uint64_t startTicks;
+		uint64_t endTicks;
+	};
+
+	// Written by its thread only, count is published after the event so a reader never sees it half written
+	// Kept when the thread ends (the trace still shows its events), a new thread takes it over
+	struct ThreadEvents
+	{
+		uint32_t threadId{};
+		std::string name{};
+		std::atomic<bool> isInUse{ true };
+		std::atomic<uint64_t> count{ 0 };
+		std::atomic<uint64_t> firstEvent{ 0 };  // Events before this were cleared
+		ProfileEvent events[Profiler::NumThreadEvents]{};
+	};
+
+	struct Registry
+	{
+		std::mutex mutex{};
+		std::vector<ThreadEvents*> threads{};
+
+		// Ticks against the clock, the tick rate follows from a second reading when writing the trace
+		std::chrono::steady_clock::time_point startTime{ std::chrono::steady_clock::now() };
+		uint64_t startTicks{ Profiler::GetTicks() };
+	};
+
+	Registry& GetRegistry()
+	{
+		static Registry registry{};
+		return registry;
+	}
+
+	ThreadEvents* AcquireThreadEvents()
+	{
+		Registry& registry{ GetRegistry() };
+		std::lock_guard<std::mutex> lock{ registry.mutex };
+
+		for(ThreadEvents* pThread : registry.threads)
+		{
+			bool isInUse{ false };
+			if(pThread->isInUse.compare_exchange_strong(isInUse, true))
+			{
+				pThread->name.clear();
+				pThread->firstEvent.store(pThread->count.load(std::memory_order_relaxed), std::memory_order_relaxed);
+				return pThread;
+			}
+		}
+
+		ThreadEvents* pThread{ new ThreadEvents{} };
+		pThread->threadId = uint32_t(registry.threads.size()) + 1;
+		registry.threads.push_back(pThread);
+		return pThread;
+	}
+
+	// Hands the buffer back when the thread ends
+	struct ThreadEventsOwner
+	{
+		ThreadEvents* pThread{ AcquireThreadEvents() };
+
+		ThreadEventsOwner() = default;
+		~ThreadEventsOwner() { pThread->isInUse.store(false); };
+
+		ThreadEventsOwner(const ThreadEventsOwner&) = delete;
+		ThreadEventsOwner& operator=(const ThreadEventsOwner&) = delete;
+		ThreadEventsOwner(ThreadEventsOwner&&) = delete;
+		ThreadEventsOwner& operator=(ThreadEventsOwner&&) = delete;
+	};
+
+	ThreadEvents& GetThreadEvents()
+	{
+		thread_local ThreadEventsOwner t_Owner{};
+		return *t_Owner.pThread;
+	}
+
+	void WriteJsonString(std::ofstream& file, const std::string& text)
+	{
+		file << '"';
+		for(const char character : text)
+		{
+			if(character == '"' || character == '\\')
+				file << '\\';
+			if(uint8_t(character) >= 0x20)
+				file << character;
+		}
+		file << '"';
+	}
+}
+
+uint64_t Profiler::GetTicks()
+{
+#ifdef DAE_HAS_RDTSC
+	return __rdtsc();
+#else
+	return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+void Profiler::AddEvent(const char* name, uint64_t startTicks, uint64_t endTicks)
+{
+	ThreadEvents& thread{ GetThreadEvents() };
+	const uint64_t count{ thread.count.load(std::memory_order_relaxed) };
+	thread.events[count % NumThreadEvents] = ProfileEvent{ name, startTicks, endTicks };
+	thread.count.store(count + 1, std::memory_order_release);
+}
+
+void Profiler::SetThreadName(const std::string& name)
+{
+	ThreadEvents& thread{ GetThreadEvents() };
+	std::lock_guard<std::mutex> lock{ GetRegistry().mutex };
+	thread.name = name;
+}
+
+bool Profiler::WriteChromeTrace(const std::string& path)
+{
+	Registry& registry{ GetRegistry() };
+
+	// Long enough between both readings for a usable tick rate
+	using namespace std::chrono;
+	if(steady_clock::now() - registry.startTime < milliseconds{ 10 })
+		std::this_thread::sleep_for(milliseconds{ 10 });
+	const double elapsedUs{ duration<double, std::micro>(steady_clock::now() - registry.startTime).count() };
+	const double ticksPerUs{ double(GetTicks() - registry.startTicks) / elapsedUs };
+
+	std::ofstream file{ path };
+	if(!file)
+		return false;
+
+	file << std::fixed << std::setprecision(3);
+	file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+	bool isFirst{ true };
+
+	std::lock_guard<std::mutex> lock{ registry.mutex };
+	std::vector<ProfileEvent> events{};
+	for(ThreadEvents* pThread : registry.threads)
+	{
+		// Copy first, then drop what the thread may have overwritten during the copy
+		const uint64_t count{ pThread->count.load(std::memory_order_acquire) };
+		const uint64_t first{ std::max(pThread->firstEvent.load(std::memory_order_relaxed), count > NumThreadEvents ? count - NumThreadEvents : 0) };
+		events.clear();
+		for(uint64_t index{ first }; index < count; ++index)
+			events.push_back(pThread->events[index % NumThreadEvents]);
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+		const uint64_t countAfter{ pThread->count.load(std::memory_order_relaxed) };
+		const uint64_t numOverwritten{ countAfter > first + NumThreadEvents ? std::min(countAfter - first - NumThreadEvents, uint64_t(events.size())) : 0 };
+
+		if(!isFirst)
+			file << ",\n";
+		isFirst = false;
+		file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << pThread->threadId << ",\"args\":{\"name\":";
+		WriteJsonString(file, pThread->name.empty() ? "Thread " + std::to_string(pThread->threadId) : pThread->name);
+		file << "}}";
+
+		for(size_t index{ size_t(numOverwritten) }; index < events.size(); ++index)
+		{
+			const ProfileEvent& event{ events[index] };
+			const double startUs{ double(int64_t(event.startTicks - registry.startTicks)) / ticksPerUs };
+			const double durationUs{ double(event.endTicks - event.startTicks) / ticksPerUs };
+			file << ",\n{\"name\":";
+			WriteJsonString(file, event.name);
+			file << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << pThread->threadId << ",\"ts\":" << startUs << ",\"dur\":" << durationUs << "}";
+		}
+	}
+
+	file << "\n]}\n";
+	return bool(file);
+}
+
+void Profiler::Clear()
+{
+	Registry& registry{ GetRegistry() };
+	std::lock_guard<std::mutex> lock{ registry.mutex };
+	for(ThreadEvents* pThread : registry.threads)
+		pThread->firstEvent.store(pThread->count.load(std::memory_order_acquire), std::memory_order_relaxed);
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+// Scoped timing markers around the stages of a frame, written out as a Chrome trace (chrome://tracing or ui.perfetto.dev)
+// Only compiled in with DAE_PROFILING defined, without it the macros are empty and nothing of this is called
+// Every thread records into a ring of its own (only that thread writes it, no locks), the oldest events get overwritten
+
+#ifdef DAE_PROFILING
+#define DAE_PROFILE_CONCAT_INNER(a, b) a##b
+#define DAE_PROFILE_CONCAT(a, b) DAE_PROFILE_CONCAT_INNER(a, b)
+
+// Times the rest of the enclosing scope, name has to be a string literal (only the pointer gets stored)
+#define DAE_PROFILE_SCOPE(name) const ProfileScope DAE_PROFILE_CONCAT(profileScope, __LINE__){ name }
+// Adds the time of the rest of the enclosing scope to ticks (uint64_t), for calls too short and too many to give each an event
+#define DAE_PROFILE_ACCUMULATE(ticks) const ProfileAccumulateScope DAE_PROFILE_CONCAT(profileAccumulate, __LINE__){ ticks }
+// Names the calling thread in the trace
+#define DAE_PROFILE_THREAD(name) Profiler::SetThreadName(name)
+#else
+#define DAE_PROFILE_SCOPE(name)
+#define DAE_PROFILE_ACCUMULATE(ticks)
+#define DAE_PROFILE_THREAD(name)
+#endif
+
+class Profiler final
+{
+public:
+	static constexpr uint32_t NumThreadEvents{ 1 << 16 };  // Per thread, a few frames worth
+
+	// Timestamp counter (rdtsc on x86), converted to time only when writing the trace
+	static uint64_t GetTicks();
+
+	static void AddEvent(const char* name, uint64_t startTicks, uint64_t endTicks);
+	static void SetThreadName(const std::string& name);
+
+	// Writes the recorded events of every thread as Chrome trace JSON, false when the file can't be written
+	// Threads may keep recording meanwhile, events they overwrote while being read are left out
+	static bool WriteChromeTrace(const std::string& path);
+	// Drops every recorded event, to start a trace at a point of interest
+	static void Clear();
+
+	static constexpr bool IsEnabled()
+	{
+#ifdef DAE_PROFILING
+		return true;
+#else
+		return false;
+#endif
+	}
+};
+
+class ProfileScope final
+{
+public:
+	explicit ProfileScope(const char* name) : m_Name{ name }, m_StartTicks{ Profiler::GetTicks() } {};
+	~ProfileScope() { Profiler::AddEvent(m_Name, m_StartTicks, Profiler::GetTicks()); };
+
+	ProfileScope(const ProfileScope&) = delete;
+	ProfileScope& operator=(const ProfileScope&) = delete;
+	ProfileScope(ProfileScope&&) = delete;
+	ProfileScope& operator=(ProfileScope&&) = delete;
+
+private:
+	const char* m_Name;
+	uint64_t m_StartTicks;
+};
+
+class ProfileAccumulateScope final
+{
+public:
+	explicit ProfileAccumulateScope(uint64_t& ticks) : m_Ticks{ ticks }, m_StartTicks{ Profiler::GetTicks() } {};
+	~ProfileAccumulateScope() { m_Ticks += Profiler::GetTicks() - m_StartTicks; };
+
+	ProfileAccumulateScope(const ProfileAccumulateScope&) = delete;
+	ProfileAccumulateScope& operator=(const ProfileAccumulateScope&) = delete;
+	ProfileAccumulateScope(ProfileAccumulateScope&&) = delete;
+	ProfileAccumulateScope& operator=(ProfileAccumulateScope&&) = delete;
+
+private:
+	uint64_t& m_Ticks;
+	uint64_t m_StartTicks;
+};
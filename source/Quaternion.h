@@ -0,0 +1,107 @@
+#pragma once
+#include "MathHelpers.h"
+#include "Vector3.h"
+#include "Vector4.h"
+#include "Matrix.h"
+
+namespace dae
+{
+	// Unit quaternion for rotations, (x, y, z) is the vector part and w the scalar part
+	// Uses the same row-vector order as Matrix: ToMatrix(a * b) == ToMatrix(a) * ToMatrix(b), so a is applied first
+	struct Quaternion
+	{
+		float x{};
+		float y{};
+		float z{};
+		float w{ 1.f };
+
+		constexpr Quaternion() = default;
+		constexpr Quaternion(float _x, float _y, float _z, float _w) : x(_x), y(_y), z(_z), w(_w) {}
+
+		static Quaternion CreateFromAxisAngle(const Vector3& axis, float angle)
+		{
+			const float halfAngle{ angle * 0.5f };
+			const Vector3 v{ axis.Normalized() * sinf(halfAngle) };
+			return { v.x, v.y, v.z, cosf(halfAngle) };
+		}
+
+		// Same rotations as Matrix::CreateRotationX/Y/Z
+		static Quaternion CreateRotationX(float pitch)
+		{
+			return CreateFromAxisAngle(Vector3::UnitX, -pitch);
+		}
+
+		static Quaternion CreateRotationY(float yaw)
+		{
+			return CreateFromAxisAngle(Vector3::UnitY, yaw);
+		}
+
+		static Quaternion CreateRotationZ(float roll)
+		{
+			return CreateFromAxisAngle(Vector3::UnitZ, roll);
+		}
+
+		float Magnitude() const
+		{
+			return sqrtf(x * x + y * y + z * z + w * w);
+		}
+
+		float Normalize()
+		{
+			const float m = Magnitude();
+			x /= m;
+			y /= m;
+			z /= m;
+			w /= m;
+
+			return m;
+		}
+
+		Quaternion Normalized() const
+		{
+			const float m = Magnitude();
+			return { x / m, y / m, z / m, w / m };
+		}
+
+		constexpr Quaternion Conjugate() const
+		{
+			return { -x, -y, -z, w };
+		}
+
+		// Rotation matrix, rows are the rotated axes
+		constexpr Matrix ToMatrix() const
+		{
+			const float xx{ x * x }, yy{ y * y }, zz{ z * z };
+			const float xy{ x * y }, xz{ x * z }, yz{ y * z };
+			const float wx{ w * x }, wy{ w * y }, wz{ w * z };
+
+			return {
+				Vector4{ 1.f - 2.f * (yy + zz), 2.f * (xy + wz), 2.f * (xz - wy), 0.f },
+				Vector4{ 2.f * (xy - wz), 1.f - 2.f * (xx + zz), 2.f * (yz + wx), 0.f },
+				Vector4{ 2.f * (xz + wy), 2.f * (yz - wx), 1.f - 2.f * (xx + yy), 0.f },
+				Vector4{ 0.f, 0.f, 0.f, 1.f }
+			};
+		}
+
+		// Rotation of this quaternion followed by the rotation of q
+		DAE_FORCEINLINE constexpr Quaternion operator*(const Quaternion& q) const
+		{
+			return {
+				q.w * x + q.x * w + q.y * z - q.z * y,
+				q.w * y - q.x * z + q.y * w + q.z * x,
+				q.w * z + q.x * y - q.y * x + q.z * w,
+				q.w * w - q.x * x - q.y * y - q.z * z
+			};
+		}
+
+		constexpr Quaternion& operator*=(const Quaternion& q)
+		{
+			*this = *this * q;
+			return *this;
+		}
+
+		static const Quaternion Identity;
+	};
+
+	inline constexpr Quaternion Quaternion::Identity{ 0, 0, 0, 1 };
+}
@@ -2,86 +2,206 @@
 #include "Renderer.h"
 #include "Camera.h"
 #include "Texture.h"
+#include "HardwareMesh.h"
+#include "HardwareTexture.h"
+#include "SoftwareRasterizer.h"
+#include "Profiler.h"
 
 #include "EffectVehicle.h"
 #include "EffectFire.h"
 #include <cassert>
 #include "Utils.h"
 
-#include <ppl.h>
+#include <SDL_image.h>
 
 using Utils::PrintColor;
 using Utils::TextColor;
 
-Renderer::Renderer(SDL_Window* pWindow):
+namespace
+{
+	// The software rasterizer only takes pixels, SDL_image does the file formats
+	Texture* LoadTextureFromFile(const std::string& path)
+	{
+		SDL_Surface* pLoadedSurface = IMG_Load(path.c_str());
+		assert(pLoadedSurface != nullptr);
+
+		// RGBA in memory, red in the lowest byte
+		SDL_Surface* pSurface = SDL_ConvertSurfaceFormat(pLoadedSurface, SDL_PIXELFORMAT_ABGR8888, 0);
+		SDL_FreeSurface(pLoadedSurface);
+		assert(pSurface != nullptr);
+
+		// Drop the row padding, if any
+		std::vector<uint32_t> pixels(size_t(pSurface->w) * pSurface->h);
+		SDL_LockSurface(pSurface);
+		for(int y{ 0 }; y < pSurface->h; ++y)
+		{
+			const uint8_t* pRow{ static_cast<const uint8_t*>(pSurface->pixels) + size_t(y) * pSurface->pitch };
+			std::copy_n(reinterpret_cast<const uint32_t*>(pRow), pSurface->w, pixels.data() + size_t(y) * pSurface->w);
+		}
+		SDL_UnlockSurface(pSurface);
+
+		Texture* pTexture{ Texture::Create(pSurface->w, pSurface->h, pixels.data()) };
+		SDL_FreeSurface(pSurface);
+		return pTexture;
+	}
+}
+
+Renderer::Renderer(SDL_Window* pWindow, const JobSystemSettings& jobSystemSettings):
+	Renderer(pWindow, 0, 0, jobSystemSettings)
+{
+}
+
+Renderer::Renderer(int width, int height, const JobSystemSettings& jobSystemSettings):
+	Renderer(nullptr, width, height, jobSystemSettings)
+{
+}
+
+Renderer::Renderer(SDL_Window* pWindow, int width, int height, const JobSystemSettings& jobSystemSettings):
 	m_pWindow(pWindow),
+	m_Width{ width },
+	m_Height{ height },
 	m_pCamera{ nullptr },
+	m_pJobSystem{ new JobSystem(jobSystemSettings) },
 	m_SceneSettings{}
 {
-	PrintConsoleCommands();
+	// Headless only has the software rasterizer, and no keys to press
+	if(IsHeadless())
+		m_RenderSettings.RenderMethod = RenderSettings::RenderMethods::Software;
+	else
+		PrintConsoleCommands();
 	PrintExtraInfo();
 
 	//Initialize
-	SDL_GetWindowSize(pWindow, &m_Width, &m_Height);
+	if(!IsHeadless())
+		SDL_GetWindowSize(pWindow, &m_Width, &m_Height);
+	assert(m_Width > 0 && m_Height > 0);
 
 	// Not in the init list, because we need the width and height from previous function
 	m_pCamera = new Camera({ 0,0,0 }, 45.0f, 1.0f, 100.0f, m_Width / (float)m_Height);
 
 
 	// Init Software Rasterizer ----------------------------
-	//Create Buffers
-	m_pFrontBuffer = SDL_GetWindowSurface(pWindow);
-	m_pBackBuffer = SDL_CreateRGBSurface(0, m_Width, m_Height, 32, 0, 0, 0, 0);
-	m_pBackBufferPixels = (uint32_t*)m_pBackBuffer->pixels;
-	m_pDepthBufferPixels = new float[m_Width * m_Height];
-
-	// Init Hardware Rasterizer ----------------------------
-	//Initialize DirectX pipeline
-	const HRESULT result = InitializeDirectX();
-	if(result == S_OK)
+	if(IsHeadless())
 	{
-		m_IsInitialized = true;
-		//std::cout << "DirectX is initialized and ready!\n";
+		// No window to show frames in, so no back buffers either: RenderToBuffer writes RGBA bytes, the layout ImageIO saves
+		m_PixelPacking = PixelPacking{ 0, 8, 16, 0xff000000u };
 	}
 	else
 	{
-		std::cout << "DirectX initialization failed!\n";
+		//Create Buffers
+		m_pFrontBuffer = SDL_GetWindowSurface(pWindow);
+		// Own the pixel memory instead of letting SDL allocate (and zero) it on this thread
+		for(uint32_t i{ 0 }; i < m_BackBuffers.Size(); ++i)
+		{
+			SoftwareBackBuffer& backBuffer{ m_BackBuffers[i] };
+			backBuffer.pPixels = new uint32_t[m_Width * m_Height];
+			backBuffer.pSurface = SDL_CreateRGBSurfaceFrom(backBuffer.pPixels, m_Width, m_Height, 32, m_Width * sizeof(uint32_t), 0, 0, 0, 0);
+		}
+		m_pBackBufferFormat = m_BackBuffers[0].pSurface->format;
+
+		// Map every channel once to find where its 8 bits go, the resolve packs the pixels itself
+		assert(m_pBackBufferFormat->BytesPerPixel == 4 && "Software back buffer needs 8 bits per channel");
+		const auto getShift = [](uint32_t channelBits)
+		{
+			uint32_t shift{ 0 };
+			while(channelBits != 0 && (channelBits & 1) == 0)
+			{
+				channelBits >>= 1;
+				++shift;
+			}
+			return shift;
+		};
+		m_PixelPacking.alphaBits = SDL_MapRGB(m_pBackBufferFormat, 0, 0, 0);
+		m_PixelPacking.redShift = getShift(SDL_MapRGB(m_pBackBufferFormat, 255, 0, 0) & ~m_PixelPacking.alphaBits);
+		m_PixelPacking.greenShift = getShift(SDL_MapRGB(m_pBackBufferFormat, 0, 255, 0) & ~m_PixelPacking.alphaBits);
+		m_PixelPacking.blueShift = getShift(SDL_MapRGB(m_pBackBufferFormat, 0, 0, 255) & ~m_PixelPacking.alphaBits);
+
+		// Same pixel layout as the window, the blit would only be a copy
+		m_CanResolveToWindow = m_pFrontBuffer->format->format == m_pBackBufferFormat->format &&
+			m_pFrontBuffer->w == m_Width && m_pFrontBuffer->h == m_Height &&
+			m_pFrontBuffer->pitch % sizeof(uint32_t) == 0;
 	}
 
+	// The rasterizer resolves straight into our pixel format
+	m_pSoftwareRasterizer = new SoftwareRasterizer(m_Width, m_Height, *m_pJobSystem, m_SceneSettings, m_PixelPacking);
+
+	// First touch: every thread writes its own tiles of the back buffers before anyone else does
+	// Headless has none, the caller owns the memory RenderToBuffer writes
+	if(!IsHeadless())
+	{
+		for(uint32_t i{ 0 }; i < m_BackBuffers.Size(); ++i)
+			m_pSoftwareRasterizer->FirstTouch(m_BackBuffers[i].pPixels, m_Width);
+	}
+
+	// Init Hardware Rasterizer ----------------------------
+	// Headless keeps the device nullptr, the textures and meshes then skip their DirectX resources
+	if(!IsHeadless())
+	{
+		//Initialize DirectX pipeline
+		const HRESULT result = InitializeDirectX();
+		if(result == S_OK)
+		{
+			m_IsInitialized = true;
+			//std::cout << "DirectX is initialized and ready!\n";
+		}
+		else
+		{
+			std::cout << "DirectX initialization failed!\n";
+		}
 
-	// Load in the resources and materials
-	m_pVehicleMaterial = new EffectVehicle{ m_pDevice, L"Resources/ShaderFiles/ShaderDefault.fx" };
-	m_pFireMaterial = new EffectFire{ m_pDevice, L"Resources/ShaderFiles/ShaderTransparent.fx" };
+		// Load in the materials
+		m_pVehicleMaterial = new EffectVehicle{ m_pDevice, L"Resources/ShaderFiles/ShaderDefault.fx" };
+		m_pFireMaterial = new EffectFire{ m_pDevice, L"Resources/ShaderFiles/ShaderTransparent.fx" };
+	}
 
-	m_pVehicleDiffuse = Texture::LoadFromFile(m_pDevice, "./Resources/vehicle_diffuse.png");
-	m_pVehicleNormal = Texture::LoadFromFile(m_pDevice, "./Resources/vehicle_normal.png");
-	m_pVehicleSpecular = Texture::LoadFromFile(m_pDevice, "./Resources/vehicle_specular.png");
-	m_pVehicleGloss = Texture::LoadFromFile(m_pDevice, "./Resources/vehicle_gloss.png");
+	// Load in the resources
 
-	m_pFireDiffuse = Texture::LoadFromFile(m_pDevice, "./Resources/fireFX_diffuse.png");
+	m_pVehicleDiffuse = LoadTextureFromFile("./Resources/vehicle_diffuse.png");
+	m_pVehicleNormal = LoadTextureFromFile("./Resources/vehicle_normal.png");
+	m_pVehicleSpecular = LoadTextureFromFile("./Resources/vehicle_specular.png");
+	m_pVehicleGloss = LoadTextureFromFile("./Resources/vehicle_gloss.png");
 
-	m_pVehicleMaterial->SetDiffuseMap(m_pVehicleDiffuse);
-	m_pVehicleMaterial->SetNormalMap(m_pVehicleNormal);
-	m_pVehicleMaterial->SetSpecularMap(m_pVehicleSpecular);
-	m_pVehicleMaterial->SetGlossinessMap(m_pVehicleGloss);
+	m_pFireDiffuse = LoadTextureFromFile("./Resources/fireFX_diffuse.png");
 
-	m_pFireMaterial->SetDiffuseMap(m_pFireDiffuse);
+	// DirectX copies for the shaders
+	const auto createHardwareTexture = [this](const Texture* pTexture)
+	{
+		return m_HardwareTexturePtrs.emplace_back(HardwareTexture::Create(m_pDevice, *pTexture));
+	};
+	if(m_pVehicleMaterial)
+	{
+		m_pVehicleMaterial->SetDiffuseMap(createHardwareTexture(m_pVehicleDiffuse));
+		m_pVehicleMaterial->SetNormalMap(createHardwareTexture(m_pVehicleNormal));
+		m_pVehicleMaterial->SetSpecularMap(createHardwareTexture(m_pVehicleSpecular));
+		m_pVehicleMaterial->SetGlossinessMap(createHardwareTexture(m_pVehicleGloss));
+	}
+	if(m_pFireMaterial)
+		m_pFireMaterial->SetDiffuseMap(createHardwareTexture(m_pFireDiffuse));
 
 	// Load in the meshes
 	std::vector<Vertex> vertices{};
 	std::vector<uint32_t> indices{};
 
 	Utils::ParseOBJ("./Resources/vehicle.obj", vertices, indices);
-	Mesh* pMesh = m_MeshPtrs.emplace_back(new Mesh{ m_pDevice, m_pVehicleMaterial, vertices, indices, {0, 0, 50.0f} });
+	Mesh* pMesh = m_MeshPtrs.emplace_back(new Mesh{ vertices, indices, {0, 0, 50.0f} });
+	pMesh->SetMaterial({ m_pVehicleDiffuse, m_pVehicleNormal, m_pVehicleSpecular, m_pVehicleGloss });
 
 	Utils::ParseOBJ("./Resources/fireFX.obj", vertices, indices);
-	pMesh = m_MeshPtrs.emplace_back(new Mesh{ m_pDevice, m_pFireMaterial, vertices, indices, {0, 0, 50.0f} });
+	pMesh = m_MeshPtrs.emplace_back(new Mesh{ vertices, indices, {0, 0, 50.0f} });
+	pMesh->SetMaterial({ m_pFireDiffuse });
+
+	// DirectX buffers of the meshes, same order
+	if(m_pDevice)
+	{
+		m_HardwareMeshPtrs.push_back(new HardwareMesh{ m_pDevice, m_pVehicleMaterial, *m_MeshPtrs[0] });
+		m_HardwareMeshPtrs.push_back(new HardwareMesh{ m_pDevice, m_pFireMaterial, *m_MeshPtrs[1] });
+	}
 
 
 	// Set the scene settings for the all supported meshes
-	for(Mesh* pMesh : m_MeshPtrs)
+	for(HardwareMesh* pHardwareMesh : m_HardwareMeshPtrs)
 	{
-		Effect* pEffect{ pMesh->GetEffect() };
+		Effect* pEffect{ pHardwareMesh->GetEffect() };
 
 		// Try casting to EffectVehicle
 		EffectVehicle* pEffectVehicle{ dynamic_cast<EffectVehicle*>(pEffect) };
@@ -104,10 +224,20 @@ Renderer::~Renderer()
 {
 	using namespace Utils;
 
+	// Render thread first, it hands frames to the present thread
+	StopRenderThread();
+	StopPresentThread();
+
+	// The geometry of a pipelined frame can still be running, it reads the meshes
+	delete m_pSoftwareRasterizer;
+
 	// Deleting software stuff
-	SDL_FreeSurface(m_pBackBuffer);
+	for(uint32_t i{ 0 }; i < m_BackBuffers.Size(); ++i)
+	{
+		SDL_FreeSurface(m_BackBuffers[i].pSurface);
+		delete[] m_BackBuffers[i].pPixels;
+	}
 	SDL_FreeSurface(m_pFrontBuffer);
-	delete[] m_pDepthBufferPixels;
 
 
 	// Deleting Direct X stuff
@@ -119,13 +249,20 @@ Renderer::~Renderer()
 
 	SafeRelease(m_pSwapChain);
 
-	m_pDeviceContext->ClearState();
-	m_pDeviceContext->Flush();
-	m_pDeviceContext->Release();
+	if(m_pDeviceContext)
+	{
+		m_pDeviceContext->ClearState();
+		m_pDeviceContext->Flush();
+		m_pDeviceContext->Release();
+	}
 
 	SafeRelease(m_pDevice);
 
 	// Deleting all the meshes
+	for(HardwareMesh* pHardwareMesh : m_HardwareMeshPtrs)
+		delete pHardwareMesh;
+	m_HardwareMeshPtrs.clear();
+
 	// Deleting using std::for_each (mostly a test what I can do with the algorithms from programming 3)
 	//std::for_each(begin(m_MeshPtrs), end(m_MeshPtrs), [](Mesh* pMesh){ delete pMesh; });
 	for(Mesh* pMesh : m_MeshPtrs)
@@ -144,12 +281,44 @@ Renderer::~Renderer()
 	delete m_pFireMaterial;
 	delete m_pFireDiffuse;
 
+	for(HardwareTexture* pHardwareTexture : m_HardwareTexturePtrs)
+		delete pHardwareTexture;
+	m_HardwareTexturePtrs.clear();
+
 	delete m_pCamera;
+
+	// Joins the worker threads
+	delete m_pJobSystem;
 }
 
 void Renderer::Update(const Timer* pTimer)
 {
-	m_pCamera->Update(pTimer);
+	// Keyboard + mouse state into camera input, the camera itself knows nothing about SDL
+	// Headless has no window that gets the keys, the camera stands still
+	CameraInput cameraInput{};
+	if(!IsHeadless())
+	{
+		const uint8_t* pKeyboardState = SDL_GetKeyboardState(nullptr);
+		int mouseX{}, mouseY{};
+		const uint32_t mouseState = SDL_GetRelativeMouseState(&mouseX, &mouseY);
+		cameraInput.boost = pKeyboardState[SDL_SCANCODE_LSHIFT];
+		cameraInput.moveForward = pKeyboardState[SDL_SCANCODE_W] || pKeyboardState[SDL_SCANCODE_UP];
+		cameraInput.moveBackward = pKeyboardState[SDL_SCANCODE_S] || pKeyboardState[SDL_SCANCODE_DOWN];
+		cameraInput.moveRight = pKeyboardState[SDL_SCANCODE_D] || pKeyboardState[SDL_SCANCODE_RIGHT];
+		cameraInput.moveLeft = pKeyboardState[SDL_SCANCODE_A] || pKeyboardState[SDL_SCANCODE_LEFT];
+		cameraInput.moveUp = pKeyboardState[SDL_SCANCODE_SPACE];
+		cameraInput.moveDown = pKeyboardState[SDL_SCANCODE_LCTRL];
+		cameraInput.pitchUp = pKeyboardState[SDL_SCANCODE_I];
+		cameraInput.pitchDown = pKeyboardState[SDL_SCANCODE_K];
+		cameraInput.yawLeft = pKeyboardState[SDL_SCANCODE_J];
+		cameraInput.yawRight = pKeyboardState[SDL_SCANCODE_L];
+		cameraInput.mouseX = mouseX;
+		cameraInput.mouseY = mouseY;
+		cameraInput.leftMouseButton = mouseState & SDL_BUTTON(SDL_BUTTON_LEFT);
+		cameraInput.rightMouseButton = mouseState & SDL_BUTTON(SDL_BUTTON_RIGHT);
+	}
+
+	m_pCamera->Update(pTimer, cameraInput);
 
 
 	if(m_RenderSettings.RotateMeshes)
@@ -164,174 +333,299 @@ void Renderer::Update(const Timer* pTimer)
 		}
 	}
 
-}
+	// The fire only exists in the hardware rasterizer
+	if(m_RenderSettings.RenderMethod == RenderSettings::RenderMethods::Hardware)
+		m_MeshPtrs.at(1)->SetVisibility(m_RenderSettings.ShowFireFX);
+	else
+		m_MeshPtrs.at(1)->SetVisibility(false);
 
+	PublishSnapshot();
+}
 
-void Renderer::Render() const
+void Renderer::PublishSnapshot()
 {
+	SceneSnapshot& snapshot{ m_Snapshots.GetWriteBuffer() };
+	snapshot.settings = m_RenderSettings;
+	snapshot.isPaused = m_PauseRenderer;
 
-	if(m_PauseRenderer)
-		return;
+	snapshot.scene.viewProjectionMatrix = m_pCamera->GetViewProjectionMatrix();
+	snapshot.scene.cameraOrigin = m_pCamera->GetOrigin();
+	snapshot.inverseViewMatrix = m_pCamera->GetInverseViewMatrix();
 
-	if(m_RenderSettings.RenderMethod == RenderSettings::RenderMethods::Hardware)
+	snapshot.scene.meshes.clear();
+	snapshot.hardwareMeshes.clear();
+	for(size_t meshIndex{ 0 }; meshIndex < m_MeshPtrs.size(); ++meshIndex)
 	{
-		m_MeshPtrs.at(1)->SetVisibility(m_RenderSettings.ShowFireFX);
+		const Mesh* pMesh{ m_MeshPtrs[meshIndex] };
+		if(!pMesh->Visible())
+			continue;
+
+		// Whole mesh outside of the view frustum, skip all of its work
+		if(!m_pCamera->IsSphereInFrustum(pMesh->GetWorldBoundingCenter(), pMesh->GetWorldBoundingRadius()))
+			continue;
 
-		RenderHardware();
+		snapshot.scene.meshes.push_back({ pMesh, pMesh->GetWorldMatrix(), pMesh->GetNormalMatrix() });
+		if(!m_HardwareMeshPtrs.empty())
+			snapshot.hardwareMeshes.push_back(m_HardwareMeshPtrs[meshIndex]);
 	}
-	else if(m_RenderSettings.RenderMethod == RenderSettings::RenderMethods::Software)
+
+	// Hand it over, a snapshot the renderer didn't get to yet is simply replaced
+	m_Snapshots.Publish();
+}
+
+void Renderer::StartRenderThread()
+{
+	if(m_IsRenderThreadRunning)
+		return;
+
+	// Nothing to render into, headless frames go through RenderToBuffer
+	if(IsHeadless())
 	{
-		m_MeshPtrs.at(1)->SetVisibility(false);
+		PrintColor("**(SHARED) No Render Thread without a window", TextColor::Yellow);
+		return;
+	}
+
+	m_IsRenderThreadRunning = true;
+	m_RenderThread = std::thread{ &Renderer::RenderThreadLoop, this };
+	PrintColor("**(SHARED) Render Thread ON", TextColor::Yellow);
+}
 
-		//@START
-		//Lock BackBuffer
-		SDL_LockSurface(m_pBackBuffer);
+void Renderer::StopRenderThread()
+{
+	if(!m_IsRenderThreadRunning)
+		return;
 
-		// Execute Software Rasterizer
-		RenderSoftware();
+	m_IsRenderThreadRunning = false;
+	m_Snapshots.WakeReader();
+	m_RenderThread.join();
+	PrintColor("**(SHARED) Render Thread OFF", TextColor::Yellow);
+}
 
-		//@END
-		//Update SDL Surface
-		SDL_UnlockSurface(m_pBackBuffer);
-		SDL_BlitSurface(m_pBackBuffer, 0, m_pFrontBuffer, 0);
-		SDL_UpdateWindowSurface(m_pWindow);
+bool Renderer::OpenRenderThreadTelemetry(const std::string& path)
+{
+	assert(!m_IsRenderThreadRunning && "The render thread writes the telemetry");
+	return m_RenderThreadTimer.OpenTelemetry(path);
+}
+
+void Renderer::RenderThreadLoop()
+{
+	DAE_PROFILE_THREAD("Render");
+
+	// Frame time = from one rendered frame to the next, the wait for a new snapshot included
+	m_RenderThreadTimer.Reset();
+	m_RenderThreadTimer.Start();
+
+	// Sleep until Update published something new, rendering the same snapshot twice shows nothing new
+	while(m_Snapshots.WaitAndAcquire(m_IsRenderThreadRunning))
+	{
+		RenderSnapshot(m_Snapshots.GetReadBuffer());
+		m_RenderThreadTimer.Update();
 	}
+	m_RenderThreadTimer.Stop();
 }
 
-void Renderer::RenderSoftware() const
+void Renderer::StartPresentThread()
 {
-	ColorRGB clearColor{ m_UniformClearColor };
+	if(m_IsPresentThreadRunning)
+		return;
 
-	// Clear uniform clear color according to setting
-	if(m_RenderSettings.UniformClearColor == false)
-		clearColor = ColorRGB{ .39f, .39f, .39f }; // Software clear color -> Light gray;
+	// Nothing to present to
+	if(IsHeadless())
+	{
+		PrintColor("**(SOFTWARE) No Present Thread without a window", TextColor::LightMagenta);
+		return;
+	}
 
-	// Software raytracer takes the color in range 0-255 and not as floats
-	clearColor *= 255.0f;
+	m_IsPresentThreadRunning = true;
+	m_PresentThread = std::thread{ &Renderer::PresentThreadLoop, this };
+	PrintColor("**(SOFTWARE) Present Thread ON", TextColor::LightMagenta);
+}
+
+void Renderer::StopPresentThread()
+{
+	if(!m_IsPresentThreadRunning)
+		return;
 
-	// Clear back buffer
-	uint32_t hexColor = 0xFF000000 | (uint32_t)clearColor.b << 16 | (uint32_t)clearColor.g << 8 | (uint32_t)clearColor.r;
-	SDL_FillRect(m_pBackBuffer, NULL, hexColor);
+	m_IsPresentThreadRunning = false;
+	m_BackBuffers.WakeReader();
+	m_PresentThread.join();
+	PrintColor("**(SOFTWARE) Present Thread OFF", TextColor::LightMagenta);
+}
 
-	// Clear depth buffer
-	std::fill_n(m_pDepthBufferPixels, m_Width * m_Height, std::numeric_limits<float>::max());
+void Renderer::PresentThreadLoop()
+{
+	DAE_PROFILE_THREAD("Present");
 
-	VertexTransformationFunction(m_MeshPtrs);
+	// Only shows finished frames, the back buffer being rendered into is never the one being read here
+	while(m_BackBuffers.WaitAndAcquire(m_IsPresentThreadRunning))
+		PresentBackBuffer(m_BackBuffers.GetReadBuffer());
+}
 
-	for(const Mesh* pMesh : m_MeshPtrs)
+void Renderer::PresentBackBuffer(const SoftwareBackBuffer& backBuffer)
+{
+	//Update SDL Surface
 	{
-		if(!pMesh->Visible())
-			continue;
+		DAE_PROFILE_SCOPE("Blit");
+		SDL_BlitSurface(backBuffer.pSurface, 0, m_pFrontBuffer, 0);
+	}
+	DAE_PROFILE_SCOPE("Present");
+	SDL_UpdateWindowSurface(m_pWindow);
+}
 
-		//VertexTransformationFunction(mesh.vertices, mesh_screen.vertices);
+void Renderer::Render()
+{
+	// Nothing to render into, headless frames go through RenderToBuffer
+	if(IsHeadless())
+		return;
+
+	// No new one, render the last one again
+	m_Snapshots.Acquire();
+	RenderSnapshot(m_Snapshots.GetReadBuffer());
+}
 
-		// If triangle strip, move only one position per itteration & inverse the direction on every odd loop
-		int increment = 3;
-		if(pMesh->GetTopology() == PrimitiveTopology::TriangleStrip)
-			increment = 1;
+bool Renderer::RenderToBuffer(uint32_t* pPixels, int pitch)
+{
+	assert(!m_IsRenderThreadRunning && "RenderToBuffer reads the snapshots the render thread is using");
+	assert(pPixels != nullptr && pitch >= m_Width);
+
+	m_Snapshots.Acquire();
+	const SceneSnapshot& snapshot{ m_Snapshots.GetReadBuffer() };
+	if(snapshot.isPaused)
+		return false;
 
+	const bool hasFrame{ RenderSoftware(snapshot, pPixels, pitch) };
+	++m_NumRenderedFrames;
+	return hasFrame;
+}
 
-		concurrency::parallel_for(0u, uint32_t((pMesh->indices.size() - 2) / increment), [=, this](uint32_t index)
+void Renderer::RenderSnapshot(const SceneSnapshot& snapshot)
+{
+	if(snapshot.isPaused)
+		return;
+
+	if(snapshot.settings.RenderMethod == RenderSettings::RenderMethods::Hardware)
+	{
+		RenderHardware(snapshot);
+	}
+	else if(snapshot.settings.RenderMethod == RenderSettings::RenderMethods::Software)
+	{
+		if(m_IsPresentThreadRunning)
+		{
+			// The present thread blits and updates the window while the next frame already renders
+			SoftwareBackBuffer& backBuffer{ m_BackBuffers.GetWriteBuffer() };
+			if(RenderSoftware(snapshot, backBuffer.pPixels, m_Width))
+				m_BackBuffers.Publish();
+		}
+		else if(m_CanResolveToWindow)
 		{
+			// Resolve straight into the window surface, no blit
+			SDL_LockSurface(m_pFrontBuffer);
+			const bool hasFrame{ RenderSoftware(snapshot, static_cast<uint32_t*>(m_pFrontBuffer->pixels), m_pFrontBuffer->pitch / int(sizeof(uint32_t))) };
+			SDL_UnlockSurface(m_pFrontBuffer);
+
+			if(hasFrame)
 			{
-				const uint32_t indiceIdx{ index * increment };
-				// Get the vertices using the indice numbers
-				const uint32_t indiceA{ pMesh->indices[indiceIdx] };
-				const uint32_t indiceB{ pMesh->indices[indiceIdx + 1] };
-				const uint32_t indiceC{ pMesh->indices[indiceIdx + 2] };
-
-				Vertex_Out A{ pMesh->vertices_out[indiceA] };
-				Vertex_Out B{ pMesh->vertices_out[indiceB] };
-				Vertex_Out C{ pMesh->vertices_out[indiceC] };
-
-				// If triangle strip, move only one position per itteration & inverse the direction on every odd loop
-
-				if(pMesh->GetTopology() == PrimitiveTopology::TriangleStrip)
-				{
-					// Check if least significant bit is 1 (odd number)
-					if((indiceIdx & 1) == 1)
-						std::swap(B, C);
-
-					// Check if any vertices of the triangle are the same (and thus the triangle has 0 area / should not be rendered)
-					if(indiceA == indiceB)
-						return;  // Return instead of continue in parallel fors
-
-					if(indiceB == indiceC)
-						return;  // Return instead of continue in parallel fors
-
-					if(indiceC == indiceA)
-						return;  // Return instead of continue in parallel fors
-
-				}
-
-
-				// Do frustum culling
-				if(A.position.z < 0.0f || A.position.z > 1.0f)
-					return;  // Return instead of continue in parallel fors
-				if(B.position.z < 0.0f || B.position.z > 1.0f)
-					return;  // Return instead of continue in parallel fors
-				if(C.position.z < 0.0f || C.position.z > 1.0f)
-					return;  // Return instead of continue in parallel fors
-
-				if(A.position.x < -1.0f || A.position.x > 1.0f)
-					if(B.position.x < -1.0f || B.position.x > 1.0f)
-						if(C.position.x < -1.0f || C.position.x > 1.0f)
-							return;  // Return instead of continue in parallel fors
-
-				if(A.position.y < -1.0f || A.position.y > 1.0f)
-					if(B.position.y < -1.0f || B.position.y > 1.0f)
-						if(C.position.y < -1.0f || C.position.y > 1.0f)
-							return;  // Return instead of continue in parallel fors
-
-
-				// Convert from NDC to ScreenSpace
-				A.position.x = (A.position.x + 1) / 2.0f * m_Width; // Screen X
-				A.position.y = (1 - A.position.y) / 2.0f * m_Height; // Screen Y,
-				B.position.x = (B.position.x + 1) / 2.0f * m_Width; // Screen X
-				B.position.y = (1 - B.position.y) / 2.0f * m_Height; // Screen Y,
-				C.position.x = (C.position.x + 1) / 2.0f * m_Width; // Screen X
-				C.position.y = (1 - C.position.y) / 2.0f * m_Height; // Screen Y,
-
-				SoftwareRenderTriangle(A, B, C);
-				
+				DAE_PROFILE_SCOPE("Present");
+				SDL_UpdateWindowSurface(m_pWindow);
 			}
-		});
+		}
+		else
+		{
+			SoftwareBackBuffer& backBuffer{ m_BackBuffers.GetWriteBuffer() };
+			if(RenderSoftware(snapshot, backBuffer.pPixels, m_Width))
+				PresentBackBuffer(backBuffer);
+		}
 	}
 
+	++m_NumRenderedFrames;
 }
 
-void Renderer::RenderHardware() const
+void Renderer::RenderHardware(const SceneSnapshot& snapshot)
 {
 	ColorRGB clearColor{ m_UniformClearColor };
 
 	if(!m_IsInitialized)
 		return;
 
+	ApplyHardwareSettings(snapshot.settings);
+
 	// Clear uniform clear color according to setting
-	if(m_RenderSettings.UniformClearColor == false)
+	if(snapshot.settings.UniformClearColor == false)
 		clearColor = ColorRGB{ .39f, .59f, .93f }; // Hardware clear color -> Cornflower blue;
 
 	// DirectX
+	// Markers only time the CPU side, the GPU works through the commands later
 	//1. CLEAR RTV & DSV
-	m_pDeviceContext->ClearRenderTargetView(m_pRenderTargetView, &clearColor.r);
-	m_pDeviceContext->ClearDepthStencilView(m_pDepthStencilView, D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.f, 0);
+	{
+		DAE_PROFILE_SCOPE("Clear");
+		m_pDeviceContext->ClearRenderTargetView(m_pRenderTargetView, &clearColor.r);
+		m_pDeviceContext->ClearDepthStencilView(m_pDepthStencilView, D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.f, 0);
+	}
 
 	// 2. SET PIPELINE + INVOKE DRAWCALLS (= RENDER)
-	for(Mesh* pMesh : m_MeshPtrs)
 	{
-		if(!pMesh->Visible())
-			continue;
-
-		Matrix worldViewProjectionMatrix{ pMesh->GetWorldMatrix() * m_pCamera->GetViewMatrix() * m_pCamera->GetProjectionMatrix() };
-		pMesh->Render(m_pDeviceContext, worldViewProjectionMatrix, m_pCamera->GetInverseViewMatrix());
+		DAE_PROFILE_SCOPE("DrawCalls");
+		for(size_t meshIndex{ 0 }; meshIndex < snapshot.scene.meshes.size(); ++meshIndex)
+		{
+			const SoftwareMeshInstance& mesh{ snapshot.scene.meshes[meshIndex] };
+			const Matrix worldViewProjectionMatrix{ mesh.worldMatrix * snapshot.scene.viewProjectionMatrix };
+			snapshot.hardwareMeshes[meshIndex]->Render(m_pDeviceContext, mesh.worldMatrix, worldViewProjectionMatrix, snapshot.inverseViewMatrix);
+		}
 	}
 
 	// SWAP THE BACKBUFFER / PRESENT
+	DAE_PROFILE_SCOPE("Present");
 	m_pSwapChain->Present(0, 0);
 }
 
+bool Renderer::RenderSoftware(const SceneSnapshot& snapshot, uint32_t* pTarget, int targetPitch)
+{
+	return m_pSoftwareRasterizer->Render(snapshot.scene, GetSoftwareRenderSettings(snapshot.settings), pTarget, targetPitch);
+}
+
+SoftwareRenderSettings Renderer::GetSoftwareRenderSettings(const RenderSettings& settings) const
+{
+	SoftwareRenderSettings softwareSettings{};
+	softwareSettings.CullMode = settings.CullMode;
+	softwareSettings.ShadingMode = settings.ShadingMode;
+	softwareSettings.UseNormalMap = settings.UseNormalMap;
+	softwareSettings.ShowDepthBuffer = settings.ShowDepthBuffer;
+	softwareSettings.ShowBoundingBox = settings.ShowBoundingBox;
+	softwareSettings.PipelinedFrames = settings.PipelinedFrames;
+	softwareSettings.SRGBOutput = settings.SRGBOutput;
+
+	// Otherwise the software default, gray
+	if(settings.UniformClearColor)
+		softwareSettings.ClearColor = m_UniformClearColor;
+
+	return softwareSettings;
+}
+
+void Renderer::ApplyHardwareSettings(const RenderSettings& settings)
+{
+	if(settings.SampleState != m_AppliedHardwareSettings.SampleState)
+	{
+		// loop over every mesh and set the effect
+		for(HardwareMesh* pHardwareMesh : m_HardwareMeshPtrs)
+		{
+			pHardwareMesh->GetEffect()->SetSamplerFilter(settings.SampleState);
+		}
+	}
+
+	if(settings.CullMode != m_AppliedHardwareSettings.CullMode)
+		SetShaderCullModes(settings.CullMode);
+
+	m_AppliedHardwareSettings = settings;
+}
+
 void Renderer::ToggleRenderMethod()
 {
+	if(IsHeadless())
+	{
+		PrintColor("**(SHARED) Headless renderer only has the SOFTWARE rasterizer", TextColor::Yellow);
+		return;
+	}
+
 	if(m_RenderSettings.RenderMethod == RenderSettings::RenderMethods::Hardware)
 	{
 		PrintColor("**(SHARED)Rasterizer Mode = SOFTWARE", TextColor::Yellow);
@@ -375,8 +669,6 @@ void Renderer::CycleCullMode()
 			PrintColor("**(SHARED) CullMode = Back", TextColor::Yellow);
 			break;
 	}
-
-	SetShaderCullModes();
 }
 
 void Renderer::ToggleUniformClearColor()
@@ -441,13 +733,6 @@ void Renderer::ToggleSampleFilter()
 				PrintColor("**(HARDWARE) Sample Filter = Point", TextColor::Green);
 				break;
 		}
-
-		// loop over every mesh and set the effect
-		for(Mesh* pMesh : m_MeshPtrs)
-		{
-			pMesh->GetEffect()->SetSamplerFilter(m_RenderSettings.SampleState);
-		}
-
 	}
 }
 
@@ -520,6 +805,34 @@ void Renderer::ToggleBoundingBox()
 	}
 }
 
+void Renderer::TogglePipelinedFrames()
+{
+	// SOFTWARE ONLY
+	if(m_RenderSettings.RenderMethod == RenderSettings::RenderMethods::Software)
+	{
+		m_RenderSettings.PipelinedFrames = !m_RenderSettings.PipelinedFrames;
+
+		if(m_RenderSettings.PipelinedFrames)
+			PrintColor("**(SOFTWARE) Pipelined Frames ON", TextColor::LightMagenta);
+		else
+			PrintColor("**(SOFTWARE) Pipelined Frames OFF", TextColor::LightMagenta);
+	}
+}
+
+void Renderer::ToggleSRGBOutput()
+{
+	// SOFTWARE ONLY
+	if(m_RenderSettings.RenderMethod == RenderSettings::RenderMethods::Software)
+	{
+		m_RenderSettings.SRGBOutput = !m_RenderSettings.SRGBOutput;
+
+		if(m_RenderSettings.SRGBOutput)
+			PrintColor("**(SOFTWARE) sRGB Output ON", TextColor::LightMagenta);
+		else
+			PrintColor("**(SOFTWARE) sRGB Output OFF", TextColor::LightMagenta);
+	}
+}
+
 void Renderer::PrintConsoleCommands()
 {
 	const TextColor sharedTextColor{ TextColor::Yellow };
@@ -532,6 +845,8 @@ void Renderer::PrintConsoleCommands()
 	PrintColor("    [F9]  Cycle CullMode (BACK/FRONT/NONE)", sharedTextColor);
 	PrintColor("    [F10] Toggle Uniform ClearColor (ON/OFF)", sharedTextColor);
 	PrintColor("    [F11] Toggle Print FPS (ON/OFF)", sharedTextColor);
+	if(Profiler::IsEnabled())
+		PrintColor("    [T]   Write Trace (trace.json)", sharedTextColor);
 	std::cout << std::endl;
 
 	PrintColor("[Key Bindings - HARDWARE]", hardwareTextColor);
@@ -544,6 +859,8 @@ void Renderer::PrintConsoleCommands()
 	PrintColor("    [F6] Toggle NormalMap (ON/OFF)", softwareTextColor);
 	PrintColor("    [F7] Toggle DepthBuffer Visualization (ON/OFF)", softwareTextColor);
 	PrintColor("    [F8] Toggle BoundingBox Visualization (ON/OFF)", softwareTextColor);
+	PrintColor("    [P]  Toggle Pipelined Frames (ON/OFF)", softwareTextColor);
+	PrintColor("    [G]  Toggle sRGB Output (ON/OFF)", softwareTextColor);
 	std::cout << std::endl;
 
 }
@@ -552,307 +869,19 @@ void Renderer::PrintExtraInfo()
 {
 	PrintColor("[Extra Features]", TextColor::LightCyan);
 	PrintColor("    Multithreading for the Software Rasterizer (VertexTransformation and Render loop)", TextColor::LightCyan);
+	PrintColor("    Work stealing job system with " + std::to_string(m_pJobSystem->GetNumWorkers()) + " worker threads (+ main thread)", TextColor::LightCyan);
+	if(m_pJobSystem->GetSettings().PinWorkers)
+		PrintColor("    Workers pinned to their own core" + std::string(m_pJobSystem->GetSettings().ReserveMainCore ? ", core 0 reserved for the main thread" : ""), TextColor::LightCyan);
 	std::cout << std::endl;
 
 }
 
-void Renderer::VertexTransformationFunction(const std::vector<Mesh*>& meshes) const
-{
-	// This upper multithreading loop might make more impact if there were more meshes, but since  i dont render the fire
-	// Theres only really one mesh to render anyway, making this kinda redundant in this scenario. but im leaving this in either way.
-
 
-			// Calculate WorldViewProjectionmatrix for every mesh	
-	for(Mesh* pMesh : meshes)
-	{
-		Matrix meshWorldMatrix{ pMesh->GetWorldMatrix() };
-		Matrix worldViewProjectionMatrix = meshWorldMatrix * (m_pCamera->GetViewMatrix() * m_pCamera->GetProjectionMatrix());
-
-		pMesh->vertices_out.clear();
-		pMesh->vertices_out.reserve(pMesh->vertices.size());
-
-		// For the parallelization, i wanted existing slots to fill in the out vertices, hen
-		// Using pushback or emplace back made the order of vertices all messed up (and ended up breaking the 3D model)
-		pMesh->vertices_out.resize(pMesh->vertices.size());
-
-		// Multithread the vertex loop
-		concurrency::parallel_for(0u, (uint32_t)pMesh->vertices.size(), [=, this](uint32_t index)
-		{
-			{
-				const Vertex& vert{ pMesh->vertices[index] };
-
-				// World to camera (view space)
-				Vector4 newPosition = worldViewProjectionMatrix.TransformPoint({ vert.position, 1.0f });
-
-				// Perspective divide 
-				newPosition.x /= newPosition.w;
-				newPosition.y /= newPosition.w;
-				newPosition.z /= newPosition.w;
-
-				// Our coords are now in NDC space
-				// Multiply the normals and tangents with the worldmatrix to convert them to worldspace
-				 //We only want to rotate them, so use transformvector, and normalize after
-				const Vector3 newNormal = meshWorldMatrix.TransformVector(vert.normal).Normalized();
-				const Vector3 newTangent = meshWorldMatrix.TransformVector(vert.tangent).Normalized();
-
-				// Calculate vert world position
-				const Vector3 vertPosition{ pMesh->GetWorldMatrix().TransformPoint(vert.position) };
-
-				// Store the new position in the vertices out as Vertex out, because this one has a position 4 / vector4
-				Vertex_Out& outVert = pMesh->vertices_out[index];
-				outVert.position = newPosition;
-				outVert.color = vert.color;
-				outVert.uv = vert.uv;
-				outVert.normal = newNormal;
-				outVert.tangent = newTangent;
-				outVert.viewDirection = { vertPosition - m_pCamera->GetOrigin() };
-			}
-		});
-	}
-}
-
-void Renderer::SoftwareRenderTriangle(Vertex_Out A, Vertex_Out B, Vertex_Out C) const
+void Renderer::SetShaderCullModes(RenderSettings::CullModes cullMode)
 {
-	// Define the edges of the screen triangle
-	const Vector2 edgeA{ A.position.GetXY(), B.position.GetXY() };
-	const Vector2 edgeB{ B.position.GetXY(), C.position.GetXY() };
-	const Vector2 edgeC{ C.position.GetXY(), A.position.GetXY() };
-
-
-	// Get the bounding box of the triangle (min max)
-	Vector2 bbMin;
-	bbMin.x = std::min(A.position.x, std::min(B.position.x, C.position.x));
-	bbMin.y = std::min(A.position.y, std::min(B.position.y, C.position.y));
-
-	Vector2 bbMax;
-	bbMax.x = std::max(A.position.x, std::max(B.position.x, C.position.x));
-	bbMax.y = std::max(A.position.y, std::max(B.position.y, C.position.y));
-
-	bbMin.x = std::clamp(bbMin.x, 0.0f, float(m_Width));
-	bbMin.y = std::clamp(bbMin.y, 0.0f, float(m_Height));
-
-	bbMax.x = std::clamp(bbMax.x, 0.0f, float(m_Width));
-	bbMax.y = std::clamp(bbMax.y, 0.0f, float(m_Height));
-
-	for(int py = int(bbMin.y); py < int(ceil(bbMax.y)); ++py)
+	for(HardwareMesh* pHardwareMesh : m_HardwareMeshPtrs)
 	{
-		for(int px = int(bbMin.x); px < int(ceil(bbMax.x)); ++px)
-		{
-			if(m_RenderSettings.ShowBoundingBox)
-			{
-				// Render white pixels where bounding box is
-				m_pBackBufferPixels[px + (py * m_Width)] = SDL_MapRGB(m_pBackBuffer->format,
-					static_cast<uint8_t>(255),
-					static_cast<uint8_t>(255),
-					static_cast<uint8_t>(255));
-				continue;
-			}
-
-			// Get the current pixel into a vector
-			Vector2 pixel{ float(px) + 0.5f, float(py) + 0.5f };  // Define pixel as 2D point (take center of the pixel)
-
-			// Get the signed areas of every edge (no division by 2 because triangle area isn't either, and we are only interested in percentage)
-			const float signedAreaParallelogramAB{ Vector2::Cross(edgeA, Vector2{ A.position.GetXY(), pixel }) };
-			const float signedAreaParallelogramBC{ Vector2::Cross(edgeB, Vector2{ B.position.GetXY(), pixel }) };
-			const float signedAreaParallelogramCA{ Vector2::Cross(edgeC, Vector2{ C.position.GetXY(), pixel }) };
-
-			// isInside will turn false if any of the below 3 caclulations returns a negative number (true &= true -> true while true &= false -> false)
-			bool isInside = true;
-
-			switch(m_RenderSettings.CullMode)
-			{
-				case RenderSettings::CullModes::BackFace:
-					isInside = signedAreaParallelogramAB > 0.0f && signedAreaParallelogramBC > 0.0f && signedAreaParallelogramCA > 0.0f;
-					break;
-				case RenderSettings::CullModes::FrontFace:
-					isInside = signedAreaParallelogramAB <= 0.0f && signedAreaParallelogramBC <= 0.0f && signedAreaParallelogramCA <= 0.0f;
-					break;
-				case RenderSettings::CullModes::None:
-					isInside = signedAreaParallelogramAB >= 0.0f && signedAreaParallelogramBC >= 0.0f && signedAreaParallelogramCA >= 0.0f;  // Inside Back
-					// inside triangle either front or back (|= "or's" the 2 together)
-					isInside |= signedAreaParallelogramAB <= 0.0f && signedAreaParallelogramBC <= 0.0f && signedAreaParallelogramCA <= 0.0f; // Inside Front
-					break;
-				default:
-					assert(false);
-			}
-
-
-			if(isInside)
-			{
-				// Get the weights of each vertex
-				const float triangleArea = Vector2::Cross(edgeA, -edgeC);
-				const float weightA{ signedAreaParallelogramBC / triangleArea };
-				const float weightB{ signedAreaParallelogramCA / triangleArea };
-				const float weightC{ signedAreaParallelogramAB / triangleArea };
-
-				// Check if total weight is +/- 1.0f;
-				assert((weightA + weightB + weightC) > 0.99f);
-				assert((weightA + weightB + weightC) < 1.01f);
-
-				// Get the interpolated Z buffer value
-				float zBuffer = 1.0f / ((weightA / A.position.z) + (weightB / B.position.z) + (weightC / C.position.z));
-
-				if(zBuffer < 0.0f || zBuffer > 1.0f)
-					continue;
-
-				// Check the depth buffer
-				if(zBuffer >= m_pDepthBufferPixels[px + (py * m_Width)])
-					continue;
-
-				m_pDepthBufferPixels[px + (py * m_Width)] = zBuffer;
-
-				float wInterpolated = 1.0f /
-					((1.0f / A.position.w) * weightA + (1.0f / B.position.w) * weightB + (1.0f / C.position.w) * weightC);
-
-				// Get the interpolated UV
-				Vector2 uvInterpolated{
-					(A.uv / A.position.w) * weightA +
-					(B.uv / B.position.w) * weightB +
-					(C.uv / C.position.w) * weightC
-				};
-				uvInterpolated *= wInterpolated;
-
-				// Get the interpolated color
-				ColorRGB colorInterpolated{
-					(A.color / A.position.w) * weightA +
-					(B.color / B.position.w) * weightB +
-					(C.color / C.position.w) * weightC
-				};
-				colorInterpolated *= wInterpolated;
-
-				// Get the interpolated normal
-				Vector3 normalInterpolated{
-					(A.normal / A.position.w) * weightA +
-					(B.normal / B.position.w) * weightB +
-					(C.normal / C.position.w) * weightC
-				};
-				normalInterpolated *= wInterpolated;
-				normalInterpolated.Normalize();
-
-				// Get the interpolated tangent
-				Vector3 tangentInterpolated{
-					(A.tangent / A.position.w) * weightA +
-					(B.tangent / B.position.w) * weightB +
-					(C.tangent / C.position.w) * weightC
-				};
-				tangentInterpolated *= wInterpolated;
-				tangentInterpolated.Normalize();
-
-				// Get the interpolated viewdirection
-				Vector3 viewDirectionInterpolated{
-					(A.viewDirection / A.position.w) * weightA +
-					(B.viewDirection / B.position.w) * weightB +
-					(C.viewDirection / C.position.w) * weightC
-				};
-				viewDirectionInterpolated *= wInterpolated;
-				viewDirectionInterpolated.Normalize();
-
-
-				Vertex_Out vertexOut{};
-				vertexOut.position = Vector4{ pixel.x, pixel.y, zBuffer, wInterpolated };
-				vertexOut.color = colorInterpolated;
-				vertexOut.uv = uvInterpolated;
-				vertexOut.normal = normalInterpolated;
-				vertexOut.tangent = tangentInterpolated;
-				vertexOut.viewDirection = viewDirectionInterpolated;
-
-				ColorRGB finalColor{};
-				if(m_RenderSettings.ShowDepthBuffer)
-				{
-					const float remapMin{ 0.970f };
-					const float remapMax{ 1.0f };
-
-					float depthColor = (Clamp(zBuffer, remapMin, remapMax) - remapMin) / (remapMax - remapMin);
-
-					finalColor = { depthColor, depthColor, depthColor };
-				}
-				else
-				{
-					finalColor = PixelShader(vertexOut);
-				}
-
-
-				finalColor.MaxToOne();
-				m_pBackBufferPixels[px + (py * m_Width)] = SDL_MapRGB(m_pBackBuffer->format,
-					static_cast<uint8_t>(finalColor.r * 255),
-					static_cast<uint8_t>(finalColor.g * 255),
-					static_cast<uint8_t>(finalColor.b * 255));
-
-			}
-		}
-	}
-}
-
-ColorRGB Renderer::PixelShader(const Vertex_Out& vert) const
-{
-	const Vector3 lightDirection{ m_SceneSettings.Light.Direction };
-	const ColorRGB lightColor{ m_SceneSettings.Light.Color };
-	const float lightIntensity{ m_SceneSettings.Light.Intensity };
-	const ColorRGB ambientColor{ m_SceneSettings.AmbientLight };
-	const float specularGlossiness{ m_SceneSettings.Shininess };  // Shininess
-
-	const ColorRGB lightRadiance{ lightColor * lightIntensity };
-
-	const ColorRGB diffuseColorSample{ m_pVehicleDiffuse->Sample(vert.uv) };
-	const ColorRGB specularColorSample{ m_pVehicleSpecular->Sample(vert.uv) };
-	const ColorRGB normalColorSample{ m_pVehicleNormal->Sample(vert.uv) };
-	const ColorRGB glossinessColor{ m_pVehicleGloss->Sample(vert.uv) };
-
-
-	//// Calculate tangent space axis
-	const Vector3 binormal{ Vector3::Cross(vert.normal, vert.tangent) };
-	const Matrix tangentSpaceAxis{ Matrix{ vert.tangent, binormal, vert.normal, Vector3::Zero } };  // {} = 0 vector
-
-
-	ColorRGB x = 2.0f * normalColorSample - colors::White;
-	////Calculate normal in tangent space
-	const Vector3 tangentNormal{ normalColorSample.r * 2.0f - 1.0f, normalColorSample.g * 2.0f - 1.0f, normalColorSample.b * 2.0f - 1.0f };
-	const Vector3 normalInTangentSpace{ tangentSpaceAxis.TransformVector(tangentNormal.Normalized()).Normalized() };
-
-	//// Select normal based on settings
-	const Vector3 currentNormal{ m_RenderSettings.UseNormalMap ? normalInTangentSpace : vert.normal };
-
-	//// Calculate observed area / lambert Cosine
-	const float observedArea{ Vector3::Dot(currentNormal, -lightDirection) };
-
-	if(observedArea < 0.0f)
-		return { 0,0,0 };
-
-
-	// Calculate lambert
-	const ColorRGB lambertDiffuse{ (1.0f * diffuseColorSample) / PI };
-
-	// Calculate phong
-	const Vector3 reflect{ lightDirection - (2.0f * Vector3::Dot(currentNormal, lightDirection) * currentNormal) };
-	const float RdotV{ std::max(0.0f, Vector3::Dot(reflect, -vert.viewDirection)) };
-	const ColorRGB phongSpecular{ specularColorSample * powf(RdotV, glossinessColor.r * specularGlossiness) }; // Glosinness map is greyscale, ro r g and b are the same
-
-	switch(m_RenderSettings.ShadingMode)
-	{
-		case RenderSettings::ShadingModes::Combined:
-			return ((lightRadiance * lambertDiffuse) + phongSpecular + ambientColor) * observedArea;
-			break;
-		case RenderSettings::ShadingModes::ObservedArea:
-			return ColorRGB{ observedArea, observedArea, observedArea };
-			break;
-		case RenderSettings::ShadingModes::Diffuse:
-			return lightRadiance * lambertDiffuse * observedArea;
-			break;
-		case RenderSettings::ShadingModes::Specular:
-			return phongSpecular;
-			break;
-		default:
-			return { 0,0,0 };
-			break;
-	}
-}
-
-
-void Renderer::SetShaderCullModes()
-{
-	for(Mesh* pMesh : m_MeshPtrs)
-	{
-		Effect* pEffect{ pMesh->GetEffect() };
+		Effect* pEffect{ pHardwareMesh->GetEffect() };
 
 		// Try casting to EffectVehicle, only set cullmode if cast worked
 		// Dynamic casts not ideal
@@ -860,7 +889,7 @@ void Renderer::SetShaderCullModes()
 		if(pEffectVehicle)
 		{
 			// I made sure the cullmode and index matched up, i didnt want cullmodes to be defined in 2 spots, hence the conversion
-			pEffectVehicle->SetCullMode(int(m_RenderSettings.CullMode));
+			pEffectVehicle->SetCullMode(int(cullMode));
 		}
 	}
 }
@@ -1,5 +1,13 @@
 #pragma once
 #include "Effect.h"
+#include "JobSystem.h"
+#include "Mesh.h"
+#include "SoftwareRasterizer.h"
+#include "Timer.h"
+#include "TripleBuffer.h"
+
+#include <atomic>
+#include <thread>
 
 struct SDL_Window;
 struct SDL_Surface;
@@ -7,25 +15,12 @@ class Camera;
 
 class EffectVehicle;
 class EffectFire;
+class HardwareMesh;
+class HardwareTexture;
+class Texture;
 
 using namespace dae;
 
-// Extra structs for the scene
-struct DirectionalLight
-{
-	Vector3 Direction{ .577f, -.577f, .577f};
-	float Intensity{ 7.f };
-	ColorRGB Color{ 1.0f, 1.0f, 1.0f };
-};
-
-struct SceneSettings
-{
-	DirectionalLight Light{};
-	ColorRGB AmbientLight{ 0.025f, 0.025f , 0.025f};
-	float Shininess{ 25.0f };
-};
-
-
 struct RenderSettings
 {
 	enum class RenderMethods
@@ -34,12 +29,9 @@ struct RenderSettings
 		Software
 	};
 
-	enum class CullModes
-	{
-		BackFace=0,
-		FrontFace=1,
-		None=2,
-	};
+	// Shared with the software rasterizer
+	using CullModes = SoftwareRenderSettings::CullModes;
+	using ShadingModes = SoftwareRenderSettings::ShadingModes;
 
 	enum class SampleStates
 	{
@@ -48,14 +40,6 @@ struct RenderSettings
 		Anisotropic
 	};
 
-	enum class ShadingModes
-	{
-		Combined,
-		ObservedArea,
-		Diffuse,		// Includes ObservedArea
-		Specular		// Includes ObservedArea
-	};
-
 	// Shared
 	RenderMethods RenderMethod = RenderMethods::Hardware;
 	bool RotateMeshes = true;
@@ -71,9 +55,29 @@ struct RenderSettings
 	bool UseNormalMap = true;
 	bool ShowDepthBuffer = false;
 	bool ShowBoundingBox = false;
+	bool PipelinedFrames = false;  // Vertex + binning of the next frame overlaps with the raster of this one, 1 frame extra latency
+	bool SRGBOutput = false;  // Encode the linear shading result to sRGB when writing the pixels
 	
 };
 
+// Copy of everything a frame reads from the scene, published by Update and consumed by Render (which can run on its own thread)
+struct SceneSnapshot
+{
+	RenderSettings settings{};
+	bool isPaused{ false };
+
+	SoftwareScene scene{};  // Camera + the visible meshes inside the view frustum
+	Matrix inverseViewMatrix{};
+	std::vector<HardwareMesh*> hardwareMeshes{};  // Of scene.meshes, same order (empty when headless)
+};
+
+// Software back buffer, an SDL surface around pixels we own
+struct SoftwareBackBuffer
+{
+	SDL_Surface* pSurface{ nullptr };
+	uint32_t* pPixels{ nullptr };
+};
+
 class Renderer final
 {
 public:
@@ -84,7 +88,13 @@ public:
 		Anisotropic
 	};
 
-	Renderer(SDL_Window* pWindow);
+	// jobSystemSettings: worker threads of the software rasterizer (count, core pinning)
+	Renderer(SDL_Window* pWindow, const JobSystemSettings& jobSystemSettings = {});
+
+	// Headless: no window and no DirectX, software only, the frames go into memory given to RenderToBuffer
+	// Works without a display or GPU (SDL only needs to be able to load the textures, no video subsystem)
+	// Windows only like the rest of Renderer, BatchRender is the headless path elsewhere (SoftwareRasterizer without a Renderer)
+	Renderer(int width, int height, const JobSystemSettings& jobSystemSettings = {});
 
 	// Rule of 5
 	~Renderer();
@@ -93,10 +103,34 @@ public:
 	Renderer& operator=(const Renderer&) = delete;
 	Renderer& operator=(Renderer&&) noexcept = delete;
 	
+	// Update publishes a snapshot of the scene, Render renders the latest one (headless only renders with RenderToBuffer)
 	void Update(const Timer* pTimer);
-	void Render() const;
-	void RenderSoftware() const;
-	void RenderHardware() const;
+	void Render();
+
+	// Renders the latest snapshot in software into pPixels (width x height, pitch in pixels, laid out as GetPixelPacking: RGBA bytes when headless)
+	// Returns false when nothing was written: paused, or no frame to show yet (pipelined mode)
+	// Don't call this while the render thread runs
+	bool RenderToBuffer(uint32_t* pPixels, int pitch);
+
+	bool IsHeadless() const { return m_pWindow == nullptr; };
+	int GetWidth() const { return m_Width; };
+	int GetHeight() const { return m_Height; };
+	const PixelPacking& GetPixelPacking() const { return m_PixelPacking; };
+
+	// Render on a thread of its own, it renders every new snapshot as soon as Update publishes it
+	// Don't call Render yourself while it runs
+	void StartRenderThread();
+	void StopRenderThread();
+	bool IsRenderThreadRunning() const { return m_IsRenderThreadRunning; };
+	uint32_t GetNumRenderedFrames() const { return m_NumRenderedFrames; };
+	// The loop calling Update only sees the update ticks while the render thread runs, this times the frames it renders instead
+	// Same output as Timer::OpenTelemetry, open it before StartRenderThread
+	bool OpenRenderThreadTelemetry(const std::string& path);
+
+	// Software frames get blitted to the window and shown by a thread of their own, rendering goes on with the next back buffer meanwhile
+	void StartPresentThread();
+	void StopPresentThread();
+	bool IsPresentThreadRunning() const { return m_IsPresentThreadRunning; };
 
 	// Shared
 	void ToggleRenderMethod();
@@ -114,9 +148,11 @@ public:
 	void ToggleNormalMap();
 	void ToggleDepthBuffer();
 	void ToggleBoundingBox();
+	void TogglePipelinedFrames();
+	void ToggleSRGBOutput();
 
 private:
-	SDL_Window* m_pWindow{};
+	SDL_Window* m_pWindow{};  // nullptr when headless
 
 	int m_Width{};
 	int m_Height{};
@@ -124,12 +160,18 @@ private:
 
 
 	bool m_IsInitialized{ false };
+
+	// Both constructors end up here, pWindow is nullptr when headless
+	Renderer(SDL_Window* pWindow, int width, int height, const JobSystemSettings& jobSystemSettings);
+
 	void PrintConsoleCommands();
 	void PrintExtraInfo();
 
 	// Shared -----------------------------
 	Camera* m_pCamera;  // Unique pointer for camera (could make it shared if needed)
+	JobSystem* m_pJobSystem;  // Worker threads for the software rasterizer loops
 	std::vector<Mesh*> m_MeshPtrs;
+	std::vector<HardwareMesh*> m_HardwareMeshPtrs;  // Same order as m_MeshPtrs, empty when headless
 	
 	RenderSettings m_RenderSettings{};
 	SceneSettings m_SceneSettings;
@@ -137,40 +179,67 @@ private:
 
 	bool m_PauseRenderer{ false };
 
-	// Textures
+	// Scene snapshots: Update writes one, Render reads one and the third is the latest published one
+	TripleBuffer<SceneSnapshot> m_Snapshots{};
+	void PublishSnapshot();
+	void RenderSnapshot(const SceneSnapshot& snapshot);
+
+	std::thread m_RenderThread{};
+	std::atomic<bool> m_IsRenderThreadRunning{ false };
+	std::atomic<uint32_t> m_NumRenderedFrames{ 0 };
+	Timer m_RenderThreadTimer{};  // Only used by the render thread while it runs
+	void RenderThreadLoop();
+
+	// Textures, the software rasterizer samples these, the shaders get a DirectX copy
 	Texture* m_pVehicleDiffuse{};
 	Texture* m_pVehicleNormal{};
 	Texture* m_pVehicleSpecular{};
 	Texture* m_pVehicleGloss{};
 	Texture* m_pFireDiffuse{};
+	std::vector<HardwareTexture*> m_HardwareTexturePtrs{};
 
 
 	// Software ----------------------------
-	void VertexTransformationFunction(const std::vector<Mesh*>& meshes) const;
-	void SoftwareRenderTriangle(Vertex_Out A, Vertex_Out B, Vertex_Out C) const;
-	ColorRGB PixelShader(const Vertex_Out& vert) const;  // Software pixel shader
+	SoftwareRasterizer* m_pSoftwareRasterizer{};
+
+	// Resolves the frame into pTarget (pitch in pixels), returns false when there was no frame to show yet (pipelined mode)
+	bool RenderSoftware(const SceneSnapshot& snapshot, uint32_t* pTarget, int targetPitch);
+	SoftwareRenderSettings GetSoftwareRenderSettings(const RenderSettings& settings) const;
+
 	SDL_Surface* m_pFrontBuffer{ nullptr };
-	SDL_Surface* m_pBackBuffer{ nullptr };
-	uint32_t* m_pBackBufferPixels{};
-	float* m_pDepthBufferPixels{};
+	TripleBuffer<SoftwareBackBuffer> m_BackBuffers{};  // Render resolves into one, the present thread shows another
+	const SDL_PixelFormat* m_pBackBufferFormat{ nullptr };
+	PixelPacking m_PixelPacking{};  // Of m_pBackBufferFormat, asked from SDL once instead of SDL_MapRGB per pixel
+	bool m_CanResolveToWindow{ false };  // Window surface has our pixel format, without present thread the frame goes straight in there
+
+	std::thread m_PresentThread{};
+	std::atomic<bool> m_IsPresentThreadRunning{ false };
+	void PresentThreadLoop();
+	void PresentBackBuffer(const SoftwareBackBuffer& backBuffer);
 
 	// Hardware -----------------------------
-	void SetShaderCullModes();  // To set cullmode inside shader using the rendersettings
+	void RenderHardware(const SceneSnapshot& snapshot);
+
+	// Effect state is only changed on the render thread, the toggles just change the settings
+	void ApplyHardwareSettings(const RenderSettings& settings);
+	void SetShaderCullModes(RenderSettings::CullModes cullMode);  // To set cullmode inside shader using the rendersettings
+	RenderSettings m_AppliedHardwareSettings{};
 	
 	HRESULT InitializeDirectX();
 
-	ID3D11Device* m_pDevice;
-	ID3D11DeviceContext* m_pDeviceContext;
+	// All nullptr when headless
+	ID3D11Device* m_pDevice{};
+	ID3D11DeviceContext* m_pDeviceContext{};
 
-	IDXGISwapChain* m_pSwapChain;
+	IDXGISwapChain* m_pSwapChain{};
 
-	ID3D11Texture2D* m_pDepthStencilBuffer;
-	ID3D11DepthStencilView* m_pDepthStencilView;
+	ID3D11Texture2D* m_pDepthStencilBuffer{};
+	ID3D11DepthStencilView* m_pDepthStencilView{};
 
-	ID3D11Texture2D* m_pRenderTargetBuffer;
-	ID3D11RenderTargetView* m_pRenderTargetView;
+	ID3D11Texture2D* m_pRenderTargetBuffer{};
+	ID3D11RenderTargetView* m_pRenderTargetView{};
 
 
-	EffectVehicle* m_pVehicleMaterial;
-	EffectFire* m_pFireMaterial;
+	EffectVehicle* m_pVehicleMaterial{};
+	EffectFire* m_pFireMaterial{};
 };
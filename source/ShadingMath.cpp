@@ -0,0 +1,146 @@
+#include "ShadingMath.h"
+
+#include <algorithm>
+#include <iostream>
+
+namespace dae
+{
+	namespace ShadingMath
+	{
+		void GlossPowTable::Initialize(float maxExponent)
+		{
+			// Linear interpolation of x^n is off by at most n(n - 1) / (8 * segments^2), the curvature is largest at x = 1
+			const auto getMaxExponent = [](int numSegments)
+			{
+				return 0.5f * (1.0f + sqrtf(1.0f + 32.0f * PowErrorBudget * float(numSegments) * float(numSegments)));
+			};
+
+			m_MaxExponent = maxExponent;
+			m_NumBaseSegments = MinBaseSegments;
+			while(getMaxExponent(m_NumBaseSegments) < maxExponent && m_NumBaseSegments < MaxBaseSegments)
+				m_NumBaseSegments *= 2;
+			m_MaxTableExponent = getMaxExponent(m_NumBaseSegments);
+			m_Values.assign(size_t(GlossLevels) * (m_NumBaseSegments + 1), 0.0f);
+
+			for(int glossLevel{ 0 }; glossLevel < GlossLevels; ++glossLevel)
+			{
+				const float exponent{ (float(glossLevel) / (GlossLevels - 1)) * maxExponent };
+				if(exponent > m_MaxTableExponent)
+					break;
+
+				float* pRow{ &m_Values[size_t(glossLevel) * (m_NumBaseSegments + 1)] };
+				for(int segment{ 0 }; segment <= m_NumBaseSegments; ++segment)
+				{
+					pRow[segment] = powf(float(segment) / m_NumBaseSegments, exponent);
+				}
+			}
+		}
+
+		void SRGBEncodeTable::Initialize()
+		{
+			m_Values.resize(Entries);
+
+			for(int entry{ 0 }; entry < Entries; ++entry)
+			{
+				const float linear{ float(entry) / (Entries - 1) };
+				const float encoded{ linear <= 0.0031308f ? linear * 12.92f : 1.055f * powf(linear, 1.0f / 2.4f) - 0.055f };
+				m_Values[entry] = static_cast<uint8_t>(encoded * 255.0f + 0.5f);
+			}
+		}
+
+		float GlossPowTable::SampleTable(float base, float glossiness) const
+		{
+			assert(!m_Values.empty() && "GlossPowTable used before Initialize");
+
+			// Glossiness comes from an 8 bit texture, so rounding picks the exact row
+			const int glossLevel{ Clamp(int(glossiness * (GlossLevels - 1) + 0.5f), 0, GlossLevels - 1) };
+
+			// Exponents below 1 are too steep near zero for linear sampling, those rows stay exact
+			// So are the ones too steep near one for the segments of the table
+			const float exponent{ (float(glossLevel) / (GlossLevels - 1)) * m_MaxExponent };
+			if(exponent < 1.0f || exponent > m_MaxTableExponent)
+				return powf(base, exponent);
+
+			const float* pRow{ &m_Values[size_t(glossLevel) * (m_NumBaseSegments + 1)] };
+
+			const float position{ Saturate(base) * m_NumBaseSegments };
+			const int segment{ std::min(int(position), m_NumBaseSegments - 1) };
+			const float factor{ position - float(segment) };
+
+			return Lerpf(pRow[segment], pRow[segment + 1], factor);
+		}
+
+		bool ValidateErrorBudget(const GlossPowTable& powTable)
+		{
+			float maxReciprocalError{};
+			float maxInverseSqrtError{};
+			float maxNormalizeError{};
+			float maxPowError{};
+
+			// Covers the ranges the pixel loop sees: w (near to far plane), triangle areas and squared lengths
+			for(float x{ 1e-3f }; x < 1e4f; x *= 1.0137f)
+			{
+				const float reciprocal{ ExactReciprocal(x) };
+				const float inverseSqrt{ ExactInverseSqrt(x) };
+				maxReciprocalError = std::max({ maxReciprocalError, abs(FastReciprocal(x) - reciprocal) / reciprocal, abs(Reciprocal(x) - reciprocal) / reciprocal });
+				maxInverseSqrtError = std::max({ maxInverseSqrtError, abs(FastInverseSqrt(x) - inverseSqrt) / inverseSqrt, abs(InverseSqrt(x) - inverseSqrt) / inverseSqrt });
+
+				// Packet versions go through different instructions, check every lane
+				const Floatx4 lanesX{ x, x * 1.25f, x * 1.5f, x * 1.75f };
+				float reciprocalLanes[2][4], inverseSqrtLanes[2][4];
+				FastReciprocal(lanesX).Store(reciprocalLanes[0]);
+				Reciprocal(lanesX).Store(reciprocalLanes[1]);
+				FastInverseSqrt(lanesX).Store(inverseSqrtLanes[0]);
+				InverseSqrt(lanesX).Store(inverseSqrtLanes[1]);
+				for(int kernel{ 0 }; kernel < 2; ++kernel)
+				{
+					for(int lane{ 0 }; lane < 4; ++lane)
+					{
+						const float laneX{ x * (1.0f + lane * 0.25f) };
+						maxReciprocalError = std::max(maxReciprocalError, abs(reciprocalLanes[kernel][lane] - ExactReciprocal(laneX)) / ExactReciprocal(laneX));
+						maxInverseSqrtError = std::max(maxInverseSqrtError, abs(inverseSqrtLanes[kernel][lane] - ExactInverseSqrt(laneX)) / ExactInverseSqrt(laneX));
+					}
+				}
+			}
+
+			for(int i{ 0 }; i < 4096; ++i)
+			{
+				// Deterministic spread of directions and lengths
+				const float angle{ float(i) * 0.0153f };
+				const Vector3 v{ cosf(angle) * (1.0f + i % 7), sinf(angle * 1.7f) * (0.5f + i % 3), cosf(angle * 0.3f) - 0.5f };
+				const Vector3 exact{ ExactNormalized(v) };
+				maxNormalizeError = std::max({ maxNormalizeError, (FastNormalized(v) - exact).Magnitude(), (Normalized(v) - exact).Magnitude() });
+			}
+
+			for(int glossLevel{ 0 }; glossLevel < GlossPowTable::GlossLevels; ++glossLevel)
+			{
+				const float glossiness{ float(glossLevel) / (GlossPowTable::GlossLevels - 1) };
+				// The segment ends and their middles (where the error is largest) of up to 2048 segments
+				for(int i{ 0 }; i <= 4096; ++i)
+				{
+					const float base{ float(i) / 4096.0f };
+					const float exact{ powf(base, glossiness * powTable.GetMaxExponent()) };
+					maxPowError = std::max({ maxPowError, abs(powTable.SampleTable(base, glossiness) - exact), abs(powTable.Sample(base, glossiness) - exact) });
+				}
+			}
+
+			const bool isValid{
+				maxReciprocalError <= ReciprocalErrorBudget &&
+				maxInverseSqrtError <= InverseSqrtErrorBudget &&
+				maxNormalizeError <= NormalizeErrorBudget &&
+				maxPowError <= PowErrorBudget
+			};
+
+			if(!isValid)
+			{
+				std::cout << "ShadingMath error budget exceeded:"
+					<< " reciprocal " << maxReciprocalError
+					<< ", inverse sqrt " << maxInverseSqrtError
+					<< ", normalize " << maxNormalizeError
+					<< ", pow " << maxPowError << "\n";
+			}
+
+			return isValid;
+		}
+	}
+}
@@ -0,0 +1,214 @@
+#pragma once
+#include <cmath>
+#include <vector>
+#include <cstdint>
+#include <emmintrin.h>
+#include "Vector3.h"
+#include "Floatx4.h"
+#include "Vector3x4.h"
+
+// Math kernels for the software pixel loop.
+// Define DAE_FAST_SHADING_MATH (set for Release in the project) to use the approximations,
+// otherwise the exact versions are used. Both are always compiled so they can be compared.
+namespace dae
+{
+	namespace ShadingMath
+	{
+		/* --- ERROR BUDGETS --- */
+		// Relative error of the refined estimates, absolute error of the normalized vectors and the pow table (one 8 bit output step)
+		// ValidateErrorBudget checks the approximations and the kernels selected for this build against these
+		constexpr float ReciprocalErrorBudget{ 1e-6f };
+		constexpr float InverseSqrtErrorBudget{ 2e-6f };
+		constexpr float NormalizeErrorBudget{ 2e-6f };
+		constexpr float PowErrorBudget{ 1.0f / 255.0f };
+
+		/* --- APPROXIMATIONS --- */
+		// Hardware estimate (12 bits) refined with one Newton-Raphson step (~22 bits)
+		inline float FastReciprocal(float x)
+		{
+			const __m128 value{ _mm_set_ss(x) };
+			const __m128 estimate{ _mm_rcp_ss(value) };
+
+			// r' = r * (2 - x * r)
+			const __m128 refined{ _mm_mul_ss(estimate, _mm_sub_ss(_mm_set_ss(2.0f), _mm_mul_ss(value, estimate))) };
+			return _mm_cvtss_f32(refined);
+		}
+
+		inline float FastInverseSqrt(float x)
+		{
+			const __m128 value{ _mm_set_ss(x) };
+			const __m128 estimate{ _mm_rsqrt_ss(value) };
+
+			// r' = 0.5 * r * (3 - x * r * r)
+			const __m128 threeMinus{ _mm_sub_ss(_mm_set_ss(3.0f), _mm_mul_ss(_mm_mul_ss(value, estimate), estimate)) };
+			const __m128 refined{ _mm_mul_ss(_mm_mul_ss(_mm_set_ss(0.5f), estimate), threeMinus) };
+			return _mm_cvtss_f32(refined);
+		}
+
+		// Dot product, rsqrt and scale all happen in one SSE register
+		inline Vector3 FastNormalized(const Vector3& v)
+		{
+			const __m128 value{ _mm_set_ps(0.0f, v.z, v.y, v.x) };
+
+			// Horizontal add of the squares, result ends up in every lane
+			__m128 sqrMagnitude{ _mm_mul_ps(value, value) };
+			sqrMagnitude = _mm_add_ps(sqrMagnitude, _mm_shuffle_ps(sqrMagnitude, sqrMagnitude, _MM_SHUFFLE(2, 3, 0, 1)));
+			sqrMagnitude = _mm_add_ps(sqrMagnitude, _mm_shuffle_ps(sqrMagnitude, sqrMagnitude, _MM_SHUFFLE(1, 0, 3, 2)));
+
+			const __m128 estimate{ _mm_rsqrt_ps(sqrMagnitude) };
+			const __m128 threeMinus{ _mm_sub_ps(_mm_set1_ps(3.0f), _mm_mul_ps(_mm_mul_ps(sqrMagnitude, estimate), estimate)) };
+			const __m128 invMagnitude{ _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(0.5f), estimate), threeMinus) };
+
+			alignas(16) float result[4];
+			_mm_store_ps(result, _mm_mul_ps(value, invMagnitude));
+			return { result[0], result[1], result[2] };
+		}
+
+		// Packet versions, same refinement on all 4 lanes
+		inline Floatx4 FastReciprocal(const Floatx4& x)
+		{
+			const Floatx4 estimate{ _mm_rcp_ps(x.value) };
+			return estimate * (2.0f - x * estimate);
+		}
+
+		inline Floatx4 FastInverseSqrt(const Floatx4& x)
+		{
+			const Floatx4 estimate{ _mm_rsqrt_ps(x.value) };
+			return 0.5f * estimate * (3.0f - x * estimate * estimate);
+		}
+
+		inline Vector3x4 FastNormalized(const Vector3x4& v)
+		{
+			return v * FastInverseSqrt(v.SqrMagnitude());
+		}
+
+		/* --- EXACT --- */
+		inline float ExactReciprocal(float x)
+		{
+			return 1.0f / x;
+		}
+
+		inline float ExactInverseSqrt(float x)
+		{
+			return 1.0f / sqrtf(x);
+		}
+
+		inline Vector3 ExactNormalized(const Vector3& v)
+		{
+			return v.Normalized();
+		}
+
+		inline Floatx4 ExactReciprocal(const Floatx4& x)
+		{
+			return 1.0f / x;
+		}
+
+		inline Floatx4 ExactInverseSqrt(const Floatx4& x)
+		{
+			return 1.0f / Sqrt(x);
+		}
+
+		inline Vector3x4 ExactNormalized(const Vector3x4& v)
+		{
+			return v.Normalized();
+		}
+
+		/* --- SELECTED PER BUILD --- */
+#if defined(DAE_FAST_SHADING_MATH)
+		inline float Reciprocal(float x) { return FastReciprocal(x); }
+		inline float InverseSqrt(float x) { return FastInverseSqrt(x); }
+		inline Vector3 Normalized(const Vector3& v) { return FastNormalized(v); }
+		inline Floatx4 Reciprocal(const Floatx4& x) { return FastReciprocal(x); }
+		inline Floatx4 InverseSqrt(const Floatx4& x) { return FastInverseSqrt(x); }
+		inline Vector3x4 Normalized(const Vector3x4& v) { return FastNormalized(v); }
+#else
+		inline float Reciprocal(float x) { return ExactReciprocal(x); }
+		inline float InverseSqrt(float x) { return ExactInverseSqrt(x); }
+		inline Vector3 Normalized(const Vector3& v) { return ExactNormalized(v); }
+		inline Floatx4 Reciprocal(const Floatx4& x) { return ExactReciprocal(x); }
+		inline Floatx4 InverseSqrt(const Floatx4& x) { return ExactInverseSqrt(x); }
+		inline Vector3x4 Normalized(const Vector3x4& v) { return ExactNormalized(v); }
+#endif
+
+		inline void Normalize(Vector3& v)
+		{
+			v = Normalized(v);
+		}
+
+		inline void Normalize(Vector3x4& v)
+		{
+			v = Normalized(v);
+		}
+
+		// pow(base, glossiness * maxExponent) for base in [0, 1]
+		// The glossiness map is 8 bit, so every possible exponent gets its own row, sampled linearly over the base.
+		// The steeper the highest exponent, the more segments the rows get to stay within PowErrorBudget
+		// Rows that would need more than MaxBaseSegments use powf instead (from an exponent of about 360)
+		class GlossPowTable final
+		{
+		public:
+			static constexpr int GlossLevels{ 256 };
+			static constexpr int MinBaseSegments{ 256 };
+			static constexpr int MaxBaseSegments{ 2048 };
+
+			void Initialize(float maxExponent);
+
+			float Sample(float base, float glossiness) const
+			{
+#if defined(DAE_FAST_SHADING_MATH)
+				return SampleTable(base, glossiness);
+#else
+				return powf(base, glossiness * m_MaxExponent);
+#endif
+			}
+
+			// Per lane lookup, the table rows can't be loaded as a packet
+			Floatx4 Sample(const Floatx4& base, const Floatx4& glossiness) const
+			{
+				float baseLanes[4], glossinessLanes[4];
+				base.Store(baseLanes);
+				glossiness.Store(glossinessLanes);
+				return { Sample(baseLanes[0], glossinessLanes[0]), Sample(baseLanes[1], glossinessLanes[1]), Sample(baseLanes[2], glossinessLanes[2]), Sample(baseLanes[3], glossinessLanes[3]) };
+			}
+
+			float SampleTable(float base, float glossiness) const;
+			float GetMaxExponent() const { return m_MaxExponent; };
+			int GetNumBaseSegments() const { return m_NumBaseSegments; };
+
+		private:
+			float m_MaxExponent{};
+			float m_MaxTableExponent{};  // Rows above it use powf
+			int m_NumBaseSegments{ MinBaseSegments };
+			std::vector<float> m_Values{};  // [GlossLevels][m_NumBaseSegments + 1]
+		};
+
+		// Linear [0, 1] to 8 bit sRGB. 4096 linear steps are finer than one output step over the whole range (also the steep part near 0)
+		class SRGBEncodeTable final
+		{
+		public:
+			static constexpr int Entries{ 4096 };
+
+			void Initialize();
+
+			uint8_t Encode(float linear) const
+			{
+				return m_Values[int(Saturate(linear) * (Entries - 1) + 0.5f)];
+			}
+
+			// Per lane lookup, returns the 4 encoded values as 32 bit integers
+			__m128i Encode(const Floatx4& linear) const
+			{
+				alignas(16) int32_t indices[4];
+				_mm_store_si128(reinterpret_cast<__m128i*>(indices), _mm_cvtps_epi32((Saturate(linear) * float(Entries - 1)).value));
+				return _mm_setr_epi32(m_Values[indices[0]], m_Values[indices[1]], m_Values[indices[2]], m_Values[indices[3]]);
+			}
+
+		private:
+			std::vector<uint8_t> m_Values{};
+		};
+
+		// Compares every approximation, and the kernel this build selected in its place, against the exact version
+		// Returns false when one exceeds its error budget
+		bool ValidateErrorBudget(const GlossPowTable& powTable);
+	}
+}
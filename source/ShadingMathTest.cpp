@@ -0,0 +1,34 @@
+#include "ShadingMath.h"
+#include "SoftwareRasterizer.h"
+
+#include <iostream>
+
+using namespace dae;
+
+// Error budget of the shading math kernels, built once with and once without DAE_FAST_SHADING_MATH (see CMakeLists.txt)
+// ValidateErrorBudget also checks the kernels the pixel loop calls in that build
+// Returns 0 when every kernel is within its budget
+
+int main()
+{
+#if defined(DAE_FAST_SHADING_MATH)
+	std::cout << "ShadingMathTest: fast shading math\n";
+#else
+	std::cout << "ShadingMathTest: exact shading math\n";
+#endif
+
+	// The pow table gets more segments the higher the shininess, and uses powf past what the most segments can hold
+	// A dull material, the default, one that needs more segments and one past the table
+	bool isValid{ true };
+	for(const float shininess : { 1.0f, SceneSettings{}.Shininess, 128.0f, 1000.0f })
+	{
+		ShadingMath::GlossPowTable powTable{};
+		powTable.Initialize(shininess);
+
+		const bool isShininessValid{ ShadingMath::ValidateErrorBudget(powTable) };
+		std::cout << "ShadingMathTest: shininess " << shininess << (isShininessValid ? " passed\n" : " FAILED\n");
+		isValid = isValid && isShininessValid;
+	}
+
+	return isValid ? 0 : 1;
+}
@@ -0,0 +1,205 @@
+#include "SharedFrameRing.h"
+
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <new>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+	// Color and depth rows start on cache lines, so readers can stream them
+	constexpr uint64_t AlignUp(uint64_t size)
+	{
+		return (size + 63) / 64 * 64;
+	}
+}
+
+SharedFrameWriter* SharedFrameWriter::Create(const std::string& name, int width, int height, uint32_t numSlots, bool hasDepth, SharedFramePolicy policy, const PixelPacking& pixelPacking)
+{
+	assert(width > 0 && height > 0 && numSlots > 0);
+
+	const uint64_t numPixels{ uint64_t(width) * height };
+	const uint64_t colorOffset{ AlignUp(sizeof(SharedFrameSlot)) };
+	const uint64_t depthOffset{ hasDepth ? colorOffset + AlignUp(numPixels * sizeof(uint32_t)) : 0 };
+	const uint64_t slotSize{ hasDepth ? depthOffset + AlignUp(numPixels * sizeof(float)) : colorOffset + AlignUp(numPixels * sizeof(uint32_t)) };
+	const size_t size{ size_t(AlignUp(sizeof(SharedFrameHeader)) + slotSize * numSlots) };
+
+	// A ring left behind by a writer that crashed gets replaced
+	shm_unlink(name.c_str());
+	const int file{ shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600) };
+	if(file < 0)
+	{
+		std::cout << "SharedFrameWriter: could not create " << name << "\n";
+		return nullptr;
+	}
+
+	void* pMapping{ ftruncate(file, off_t(size)) == 0 ? mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0) : MAP_FAILED };
+	close(file);
+	if(pMapping == MAP_FAILED)
+	{
+		std::cout << "SharedFrameWriter: could not map " << size << " bytes for " << name << "\n";
+		shm_unlink(name.c_str());
+		return nullptr;
+	}
+
+	SharedFrameWriter* pWriter{ new SharedFrameWriter{} };
+	pWriter->m_Name = name;
+	pWriter->m_Size = size;
+	pWriter->m_Policy = policy;
+
+	SharedFrameHeader* pHeader{ new(pMapping) SharedFrameHeader{} };
+	pHeader->version = SharedFrameHeader::Version;
+	pHeader->width = uint32_t(width);
+	pHeader->height = uint32_t(height);
+	pHeader->numSlots = numSlots;
+	pHeader->hasDepth = hasDepth ? 1 : 0;
+	pHeader->pixelPacking = pixelPacking;
+	pHeader->slotSize = slotSize;
+	pHeader->colorOffset = colorOffset;
+	pHeader->depthOffset = depthOffset;
+	pWriter->m_pHeader = pHeader;
+
+	for(uint64_t sequence{ 1 }; sequence <= numSlots; ++sequence)
+		new(pWriter->GetSlot(sequence)) SharedFrameSlot{};
+
+	// Readers that find the magic see the whole header
+	pHeader->magic.store(SharedFrameHeader::Magic, std::memory_order_release);
+	return pWriter;
+}
+
+SharedFrameWriter::~SharedFrameWriter()
+{
+	munmap(m_pHeader, m_Size);
+	shm_unlink(m_Name.c_str());
+}
+
+bool SharedFrameWriter::BeginFrame(Frame& frame)
+{
+	assert(m_pOpenSlot == nullptr && "BeginFrame without EndFrame or CancelFrame");
+
+	const uint64_t sequence{ m_Sequence + 1 };
+	if(m_Policy == SharedFramePolicy::Drop && sequence - m_pHeader->releasedSequence.load(std::memory_order_acquire) > m_pHeader->numSlots)
+	{
+		m_pHeader->numDropped.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	// Odd version: readers of the frame that was in this slot know it's going
+	m_pOpenSlot = GetSlot(sequence);
+	m_pOpenSlot->version.store(m_pOpenSlot->version.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	char* pSlot{ reinterpret_cast<char*>(m_pOpenSlot) };
+	frame.pColor = reinterpret_cast<uint32_t*>(pSlot + m_pHeader->colorOffset);
+	frame.pDepth = m_pHeader->hasDepth ? reinterpret_cast<float*>(pSlot + m_pHeader->depthOffset) : nullptr;
+	return true;
+}
+
+void SharedFrameWriter::EndFrame(uint64_t frameIndex)
+{
+	assert(m_pOpenSlot != nullptr);
+
+	++m_Sequence;
+	m_pOpenSlot->sequence = m_Sequence;
+	m_pOpenSlot->frameIndex = frameIndex;
+	m_pOpenSlot->timestampNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+
+	m_pOpenSlot->version.store(m_pOpenSlot->version.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	m_pHeader->publishedSequence.store(m_Sequence, std::memory_order_release);
+	m_pOpenSlot = nullptr;
+}
+
+void SharedFrameWriter::CancelFrame()
+{
+	assert(m_pOpenSlot != nullptr);
+
+	// Even again, but a new version: whatever was in the slot before may be half overwritten
+	m_pOpenSlot->sequence = 0;
+	m_pOpenSlot->version.store(m_pOpenSlot->version.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	m_pOpenSlot = nullptr;
+}
+
+uint64_t SharedFrameWriter::GetNumDropped() const
+{
+	return m_pHeader->numDropped.load(std::memory_order_relaxed);
+}
+
+SharedFrameSlot* SharedFrameWriter::GetSlot(uint64_t sequence) const
+{
+	char* pSlots{ reinterpret_cast<char*>(m_pHeader) + AlignUp(sizeof(SharedFrameHeader)) };
+	return reinterpret_cast<SharedFrameSlot*>(pSlots + (sequence - 1) % m_pHeader->numSlots * m_pHeader->slotSize);
+}
+
+SharedFrameReader* SharedFrameReader::Open(const std::string& name)
+{
+	const int file{ shm_open(name.c_str(), O_RDWR, 0) };
+	if(file < 0)
+		return nullptr;
+
+	struct stat fileInfo{};
+	const bool hasSize{ fstat(file, &fileInfo) == 0 && size_t(fileInfo.st_size) >= sizeof(SharedFrameHeader) };
+	void* pMapping{ hasSize ? mmap(nullptr, size_t(fileInfo.st_size), PROT_READ | PROT_WRITE, MAP_SHARED, file, 0) : MAP_FAILED };
+	close(file);
+	if(pMapping == MAP_FAILED)
+		return nullptr;
+
+	// Not (completely) set up yet, or something else under that name
+	SharedFrameHeader* pHeader{ static_cast<SharedFrameHeader*>(pMapping) };
+	if(pHeader->magic.load(std::memory_order_acquire) != SharedFrameHeader::Magic || pHeader->version != SharedFrameHeader::Version)
+	{
+		munmap(pMapping, size_t(fileInfo.st_size));
+		return nullptr;
+	}
+
+	SharedFrameReader* pReader{ new SharedFrameReader{} };
+	pReader->m_pHeader = pHeader;
+	pReader->m_Size = size_t(fileInfo.st_size);
+	return pReader;
+}
+
+SharedFrameReader::~SharedFrameReader()
+{
+	munmap(m_pHeader, m_Size);
+}
+
+bool SharedFrameReader::GetFrame(uint64_t sequence, Frame& frame) const
+{
+	if(sequence == 0 || sequence > GetPublishedSequence())
+		return false;
+
+	const SharedFrameSlot* pSlot{ GetSlot(sequence) };
+	frame.version = pSlot->version.load(std::memory_order_acquire);
+	frame.sequence = pSlot->sequence;
+	frame.frameIndex = pSlot->frameIndex;
+	frame.timestampNs = pSlot->timestampNs;
+	if(frame.version % 2 != 0 || frame.sequence != sequence)
+		return false;
+
+	const char* pSlotData{ reinterpret_cast<const char*>(pSlot) };
+	frame.pColor = reinterpret_cast<const uint32_t*>(pSlotData + m_pHeader->colorOffset);
+	frame.pDepth = m_pHeader->hasDepth ? reinterpret_cast<const float*>(pSlotData + m_pHeader->depthOffset) : nullptr;
+	return IsValid(frame);
+}
+
+bool SharedFrameReader::IsValid(const Frame& frame) const
+{
+	// Everything read before this can't come from a later write than the version says
+	std::atomic_thread_fence(std::memory_order_acquire);
+	return GetSlot(frame.sequence)->version.load(std::memory_order_relaxed) == frame.version;
+}
+
+void SharedFrameReader::Release(uint64_t sequence)
+{
+	m_pHeader->releasedSequence.store(sequence, std::memory_order_release);
+}
+
+const SharedFrameSlot* SharedFrameReader::GetSlot(uint64_t sequence) const
+{
+	const char* pSlots{ reinterpret_cast<const char*>(m_pHeader) + AlignUp(sizeof(SharedFrameHeader)) };
+	return reinterpret_cast<const SharedFrameSlot*>(pSlots + (sequence - 1) % m_pHeader->numSlots * m_pHeader->slotSize);
+}
@@ -0,0 +1,136 @@
+#pragma once
+#include "SoftwareRasterizer.h"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Frame ring in POSIX shared memory (shm_open), for other processes to read the rendered frames in place: no copies, no files
+// Layout: SharedFrameHeader, then numSlots slots of slotSize bytes: SharedFrameSlot, color (width x height 32 bit pixels), depth (width x height floats, optional)
+// One writer (the renderer), one reader that releases what it read, any number of readers that only peek
+// The writer never waits on a reader: with Overwrite it reuses the oldest slot, a reader that was still in it notices through the slot version
+
+// Filled in by the writer before it publishes anything, magic last
+struct SharedFrameHeader
+{
+	static constexpr uint32_t Magic{ 0x46454144 };  // "DAEF"
+	static constexpr uint32_t Version{ 1 };
+
+	std::atomic<uint32_t> magic{ 0 };
+	uint32_t version{};
+	uint32_t width{};
+	uint32_t height{};
+	uint32_t numSlots{};
+	uint32_t hasDepth{};
+	PixelPacking pixelPacking{};
+	uint64_t slotSize{};  // Bytes, the first slot starts at sizeof(SharedFrameHeader)
+	uint64_t colorOffset{};  // Bytes from the start of a slot
+	uint64_t depthOffset{};  // 0 without depth
+
+	alignas(64) std::atomic<uint64_t> publishedSequence{ 0 };  // Newest complete frame, 0 = none yet. Frame n is in slot (n - 1) % numSlots
+	alignas(64) std::atomic<uint64_t> releasedSequence{ 0 };  // Newest frame the releasing reader is done with
+	std::atomic<uint64_t> numDropped{ 0 };  // Frames the writer dropped because the ring was full (Drop policy)
+};
+
+// Start of every slot
+struct alignas(64) SharedFrameSlot
+{
+	std::atomic<uint64_t> version{ 0 };  // Odd while the writer is in the slot, changes every time it gets written
+	uint64_t sequence{};  // Ring sequence number of the frame in it
+	uint64_t frameIndex{};  // The writer's own frame number
+	int64_t timestampNs{};  // steady_clock of the writer when the frame was published
+};
+
+// What the writer does when the releasing reader still has to read the slot it is about to reuse
+enum class SharedFramePolicy
+{
+	Overwrite,  // Reuse it anyway, the reader always sees the newest frames
+	Drop,  // Drop the new frame, the reader gets every frame up to the ones that didn't fit
+};
+
+// Writer side, creates (and on delete removes) the shared memory object
+class SharedFrameWriter final
+{
+public:
+	// Where to render a frame, straight into its slot
+	struct Frame
+	{
+		uint32_t* pColor{ nullptr };  // width x height, pitch = width
+		float* pDepth{ nullptr };  // nullptr without depth
+	};
+
+	// name like "/dae_frames", nullptr when it can't be created
+	static SharedFrameWriter* Create(const std::string& name, int width, int height, uint32_t numSlots, bool hasDepth, SharedFramePolicy policy, const PixelPacking& pixelPacking = {});
+
+	~SharedFrameWriter();
+	SharedFrameWriter(const SharedFrameWriter&) = delete;
+	SharedFrameWriter& operator=(const SharedFrameWriter&) = delete;
+	SharedFrameWriter(SharedFrameWriter&&) = delete;
+	SharedFrameWriter& operator=(SharedFrameWriter&&) = delete;
+
+	// Opens the next slot for writing, false when the frame gets dropped (Drop policy, ring full)
+	// Never waits. Every Begin that returned true needs an End or a Cancel
+	bool BeginFrame(Frame& frame);
+	// Publishes the frame
+	void EndFrame(uint64_t frameIndex);
+	// Nothing got written after all (pipelined frame without an image), the slot goes back unpublished
+	void CancelFrame();
+
+	uint64_t GetNumPublished() const { return m_Sequence; };
+	uint64_t GetNumDropped() const;
+
+private:
+	SharedFrameWriter() = default;
+
+	std::string m_Name{};
+	SharedFrameHeader* m_pHeader{ nullptr };
+	size_t m_Size{};
+	SharedFramePolicy m_Policy{};
+	uint64_t m_Sequence{ 0 };  // Last published
+	SharedFrameSlot* m_pOpenSlot{ nullptr };
+
+	SharedFrameSlot* GetSlot(uint64_t sequence) const;
+};
+
+// Reader side, for the consumers (see the layout above to read it without this class)
+class SharedFrameReader final
+{
+public:
+	// Pointers into the ring, valid until the writer reuses the slot: check IsValid after using them
+	struct Frame
+	{
+		const uint32_t* pColor{ nullptr };
+		const float* pDepth{ nullptr };
+		uint64_t sequence{};
+		uint64_t frameIndex{};
+		int64_t timestampNs{};
+		uint64_t version{};
+	};
+
+	// nullptr when there is no ring with that name (yet)
+	static SharedFrameReader* Open(const std::string& name);
+
+	~SharedFrameReader();
+	SharedFrameReader(const SharedFrameReader&) = delete;
+	SharedFrameReader& operator=(const SharedFrameReader&) = delete;
+	SharedFrameReader(SharedFrameReader&&) = delete;
+	SharedFrameReader& operator=(SharedFrameReader&&) = delete;
+
+	const SharedFrameHeader& GetHeader() const { return *m_pHeader; };
+	uint64_t GetPublishedSequence() const { return m_pHeader->publishedSequence.load(std::memory_order_acquire); };
+
+	// False when frame sequence isn't in the ring (not published yet, or already overwritten)
+	bool GetFrame(uint64_t sequence, Frame& frame) const;
+	// True when the writer didn't touch the slot since GetFrame, so whatever got read from it is the whole frame
+	bool IsValid(const Frame& frame) const;
+	// Done with every frame up to sequence, the writer may reuse their slots (only matters with the Drop policy)
+	void Release(uint64_t sequence);
+
+private:
+	SharedFrameReader() = default;
+
+	SharedFrameHeader* m_pHeader{ nullptr };
+	size_t m_Size{};
+
+	const SharedFrameSlot* GetSlot(uint64_t sequence) const;
+};
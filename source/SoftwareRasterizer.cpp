@@ -0,0 +1,1022 @@
+#include "SoftwareRasterizer.h"
+#include "Profiler.h"
+#include "Texture.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstring>
+#include <emmintrin.h>
+#include <limits>
+#include <utility>
+
+#ifdef DAE_PROFILING
+namespace
+{
+	// Pixel shader time of the tile the thread is rastering
+	thread_local uint64_t t_PixelShaderTicks{ 0 };
+}
+#endif
+
+SoftwareRasterizer::SoftwareRasterizer(int width, int height, JobSystem& jobSystem, const SceneSettings& sceneSettings, const PixelPacking& pixelPacking):
+	m_Width{ width },
+	m_Height{ height },
+	m_JobSystem{ jobSystem },
+	m_SceneSettings{ sceneSettings },
+	m_PixelPacking{ pixelPacking }
+{
+	assert(m_Width > 0 && m_Height > 0);
+
+	// Split the screen in tiles
+	m_NumTilesX = (m_Width + SoftwareTile::Size - 1) / SoftwareTile::Size;
+	m_NumTilesY = (m_Height + SoftwareTile::Size - 1) / SoftwareTile::Size;
+	for(int tileY{ 0 }; tileY < m_NumTilesY; ++tileY)
+	{
+		for(int tileX{ 0 }; tileX < m_NumTilesX; ++tileX)
+		{
+			SoftwareTile tile{};
+			tile.minX = tileX * SoftwareTile::Size;
+			tile.minY = tileY * SoftwareTile::Size;
+			tile.maxX = std::min(tile.minX + SoftwareTile::Size, m_Width);
+			tile.maxY = std::min(tile.minY + SoftwareTile::Size, m_Height);
+			m_SoftwareTiles.push_back(tile);
+		}
+	}
+
+	m_pSoftwareFrames[0] = new SoftwareFrame{ m_JobSystem };
+	m_pSoftwareFrames[1] = new SoftwareFrame{ m_JobSystem };
+
+	// First touch: every thread allocates and writes its own tiles before anyone else does
+	m_JobSystem.RunOnEachThread([this](uint32_t threadIndex) { AllocateTiles(threadIndex); });
+
+	// Lookup table for the software phong term, depends on the scene shininess
+	m_SpecularPowTable.Initialize(m_SceneSettings.Shininess);
+	m_SRGBEncodeTable.Initialize();
+}
+
+SoftwareRasterizer::~SoftwareRasterizer()
+{
+	// The geometry of a pipelined frame can still be running
+	for(SoftwareFrame* pFrame : m_pSoftwareFrames)
+	{
+		pFrame->geometryGraph.Wait();
+		delete pFrame;
+	}
+
+	for(SoftwareTile& tile : m_SoftwareTiles)
+	{
+		delete[] tile.pColor;
+		delete[] tile.pDepth;
+	}
+}
+
+void SoftwareRasterizer::Wait()
+{
+	for(SoftwareFrame* pFrame : m_pSoftwareFrames)
+		pFrame->geometryGraph.Wait();
+}
+
+void SoftwareRasterizer::FirstTouch(uint32_t* pTarget, int targetPitch)
+{
+	m_JobSystem.RunOnEachThread([=, this](uint32_t threadIndex)
+	{
+		for(uint32_t tileIndex{ 0 }; tileIndex < m_SoftwareTiles.size(); ++tileIndex)
+		{
+			if(!IsTileOwner(tileIndex, threadIndex))
+				continue;
+
+			// Black in the target pixel format
+			const SoftwareTile& tile{ m_SoftwareTiles[tileIndex] };
+			for(int py{ tile.minY }; py < tile.maxY; ++py)
+				std::fill_n(pTarget + tile.minX + py * targetPitch, tile.maxX - tile.minX, m_PixelPacking.alphaBits);
+		}
+	});
+}
+
+void SoftwareRasterizer::CopyDepth(float* pTarget, int targetPitch) const
+{
+	m_JobSystem.ParallelFor(0, static_cast<uint32_t>(m_SoftwareTiles.size()), [=, this](uint32_t tileIndex)
+	{
+		const SoftwareTile& tile{ m_SoftwareTiles[tileIndex] };
+		for(int py{ tile.minY }; py < tile.maxY; ++py)
+			std::copy_n(tile.pDepth + tile.GetLocalIndex(tile.minX, py), tile.maxX - tile.minX, pTarget + tile.minX + py * targetPitch);
+	});
+}
+
+bool SoftwareRasterizer::Render(const SoftwareScene& scene, const SoftwareRenderSettings& settings, uint32_t* pTarget, int targetPitch, const YUVTarget* pYUVTarget)
+{
+	DAE_PROFILE_SCOPE("SoftwareRender");
+
+	SoftwareFrame& frame{ *m_pSoftwareFrames[m_SoftwareFrameIndex] };
+	SoftwareFrame& previousFrame{ *m_pSoftwareFrames[m_SoftwareFrameIndex ^ 1] };
+
+	if(!settings.PipelinedFrames)
+	{
+		// Left over from the pipelined mode, that frame is never shown
+		previousFrame.geometryGraph.Wait();
+		previousFrame.isGeometryStarted = false;
+
+		SetupSoftwareFrame(frame, scene, settings);
+		StartSoftwareGeometry(frame);
+		RenderSoftwareTiles(frame, settings, pTarget, targetPitch, pYUVTarget);
+		MergeStatistics(frame);
+		return true;
+	}
+
+	// Pipelined: start the geometry of this frame, then raster the previous one while it runs
+	// Right after switching modes there is no previous frame, the target then just keeps the last image
+	SetupSoftwareFrame(frame, scene, settings);
+	StartSoftwareGeometry(frame);
+	const bool hasFrame{ previousFrame.isGeometryStarted };
+	if(hasFrame)
+	{
+		RenderSoftwareTiles(previousFrame, settings, pTarget, targetPitch, pYUVTarget);
+		MergeStatistics(previousFrame);
+	}
+
+	// The next frame gets set up in the one that just got rastered
+	m_SoftwareFrameIndex ^= 1;
+	return hasFrame;
+}
+
+void SoftwareRasterizer::SetupSoftwareFrame(SoftwareFrame& frame, const SoftwareScene& scene, const SoftwareRenderSettings& settings) const
+{
+	// Never the case in the normal order, but never overwrite a frame that is still being worked on
+	frame.geometryGraph.Wait();
+	frame.isGeometryStarted = false;
+
+	frame.viewProjectionMatrix = scene.viewProjectionMatrix;
+	frame.cameraOrigin = scene.cameraOrigin;
+
+	frame.firstRow = std::clamp(settings.FirstRow, 0, m_Height);
+	frame.lastRow = settings.LastRow < 0 ? m_Height : std::clamp(settings.LastRow, frame.firstRow, m_Height);
+
+	for(SoftwareStatisticsSlot& slot : frame.statistics)
+		slot.statistics = {};
+
+	frame.numMeshes = 0;
+	for(const SoftwareMeshInstance& mesh : scene.meshes)
+	{
+		assert(mesh.pMesh != nullptr);
+
+		if(frame.numMeshes == frame.meshes.size())
+			frame.meshes.emplace_back();
+
+		frame.meshes[frame.numMeshes++].mesh = mesh;
+	}
+}
+
+void SoftwareRasterizer::StartSoftwareGeometry(SoftwareFrame& frame) const
+{
+	// Build the geometry as a task graph, every task starts as soon as its own inputs are ready
+	TaskGraph& geometryGraph{ frame.geometryGraph };
+	geometryGraph.Clear();
+	frame.numBinningChunks = 0;
+
+	for(uint32_t meshIndex{ 0 }; meshIndex < frame.numMeshes; ++meshIndex)
+	{
+		const Mesh* pMesh{ frame.meshes[meshIndex].mesh.pMesh };
+		SoftwareFrame* pFrame{ &frame };
+
+		const TaskGraph::TaskId vertexTask{ geometryGraph.AddTask([=, this]() { VertexTransformationFunction(*pFrame, meshIndex); }) };
+
+		// Triangle strip moves one index per triangle, triangle list moves 3
+		const uint32_t numIndices{ static_cast<uint32_t>(pMesh->indices.size()) };
+		uint32_t numTriangles{ numIndices / 3 };
+		if(pMesh->GetTopology() == PrimitiveTopology::TriangleStrip)
+			numTriangles = numIndices >= 3 ? numIndices - 2 : 0;
+
+		// Bin the triangles of this mesh in chunks, each chunk only waits on the vertices of its own mesh
+		for(uint32_t firstTriangle{ 0 }; firstTriangle < numTriangles; firstTriangle += BinningChunk::NumTriangles)
+		{
+			if(frame.numBinningChunks == frame.binningChunks.size())
+				frame.binningChunks.emplace_back();
+
+			// Index, not a reference, the chunk vector can still grow while the graph is being built
+			const uint32_t chunkIndex{ frame.numBinningChunks++ };
+			BinningChunk& chunk{ frame.binningChunks[chunkIndex] };
+			chunk.meshIndex = meshIndex;
+			chunk.firstTriangle = firstTriangle;
+			chunk.lastTriangle = std::min(firstTriangle + BinningChunk::NumTriangles, numTriangles);
+
+			const TaskGraph::TaskId binningTask{ geometryGraph.AddTask([=, this]() { BinTriangles(*pFrame, chunkIndex); }) };
+			geometryGraph.AddDependency(vertexTask, binningTask);
+		}
+	}
+
+	geometryGraph.Start();
+	frame.isGeometryStarted = true;
+}
+
+void SoftwareRasterizer::MergeStatistics(const SoftwareFrame& frame)
+{
+	m_Statistics = {};
+	for(const SoftwareStatisticsSlot& slot : frame.statistics)
+		m_Statistics.Add(slot.statistics);
+	m_Statistics.numPixels = uint64_t(m_Width) * (frame.lastRow - frame.firstRow);
+}
+
+void SoftwareRasterizer::RenderSoftwareTiles(SoftwareFrame& frame, const SoftwareRenderSettings& settings, uint32_t* pTarget, int targetPitch, const YUVTarget* pYUVTarget) const
+{
+	const ColorRGB clearColor{ settings.ClearColor };
+
+	// Select the raster permutation once, the settings are constant for the whole frame
+	const RasterTriangleFunction rasterTriangle{ SelectRasterTriangleFunction(settings) };
+
+	// A tile needs every triangle that could touch it, so all of the binning has to be done
+	frame.geometryGraph.Wait();
+	frame.isGeometryStarted = false;
+
+	// Every tile gets resolved right after it is done
+	TaskGraph tileGraph{ m_JobSystem };
+	SoftwareFrame* pFrame{ &frame };
+	const bool encodeSRGB{ settings.SRGBOutput };
+	const int firstRow{ frame.firstRow };
+	const int lastRow{ frame.lastRow };
+	const bool hasYUVTarget{ pYUVTarget != nullptr };
+	const YUVTarget yuvTarget{ hasYUVTarget ? *pYUVTarget : YUVTarget{} };
+	for(uint32_t tileIndex{ 0 }; tileIndex < m_SoftwareTiles.size(); ++tileIndex)
+	{
+		// Outside of the band of this frame
+		const SoftwareTile& tile{ m_SoftwareTiles[tileIndex] };
+		if(tile.maxY <= firstRow || tile.minY >= lastRow)
+			continue;
+
+		const int owner{ GetTileOwner(tileIndex) };
+
+		const TaskGraph::TaskId rasterTask{ tileGraph.AddTask([=, this]() { RasterTile(*pFrame, tileIndex, rasterTriangle, clearColor); }, owner) };
+		// The tile is still in the cache of the thread that rastered it, every output converts from there
+		const TaskGraph::TaskId resolveTask{ tileGraph.AddTask([=, this]()
+		{
+			DAE_PROFILE_SCOPE("Resolve");
+			if(pTarget)
+				ResolveTile(tileIndex, pTarget, targetPitch, encodeSRGB, firstRow, lastRow);
+			if(hasYUVTarget)
+				ResolveTileYUV(tileIndex, yuvTarget, encodeSRGB, firstRow, lastRow);
+		}, owner) };
+		tileGraph.AddDependency(rasterTask, resolveTask);
+	}
+
+	// The target is complete once this returns
+	tileGraph.Run();
+}
+
+int SoftwareRasterizer::GetTileOwner(uint32_t tileIndex) const
+{
+	// No workers, the main thread does everything
+	const uint32_t numWorkers{ m_JobSystem.GetNumWorkers() };
+	if(numWorkers == 0)
+		return -1;
+
+	return static_cast<int>(tileIndex * numWorkers / m_SoftwareTiles.size());
+}
+
+bool SoftwareRasterizer::IsTileOwner(uint32_t tileIndex, uint32_t threadIndex) const
+{
+	// Tiles without an owner belong to the calling thread (threadIndex == numWorkers)
+	const int owner{ GetTileOwner(tileIndex) };
+	return owner == static_cast<int>(threadIndex) || (owner < 0 && threadIndex == m_JobSystem.GetNumWorkers());
+}
+
+void SoftwareRasterizer::AllocateTiles(uint32_t threadIndex)
+{
+	for(uint32_t tileIndex{ 0 }; tileIndex < m_SoftwareTiles.size(); ++tileIndex)
+	{
+		if(!IsTileOwner(tileIndex, threadIndex))
+			continue;
+
+		SoftwareTile& tile{ m_SoftwareTiles[tileIndex] };
+		tile.pColor = new float[3 * SoftwareTile::NumPixels];
+		tile.pDepth = new float[SoftwareTile::NumPixels];
+
+		std::fill_n(tile.pColor, 3 * SoftwareTile::NumPixels, 0.0f);
+		std::fill_n(tile.pDepth, SoftwareTile::NumPixels, std::numeric_limits<float>::max());
+	}
+}
+
+void SoftwareRasterizer::VertexTransformationFunction(SoftwareFrame& frame, uint32_t meshIndex) const
+{
+	DAE_PROFILE_SCOPE("VertexTransformationFunction");
+
+	// Runs as one task per mesh in the frame graph, the vertices themselves are split over the workers again
+	SoftwareMeshState& meshState{ frame.meshes[meshIndex] };
+	const Mesh* pMesh{ meshState.mesh.pMesh };
+
+	// Only the copies in the frame, the caller can already be moving the camera and mesh again
+	const Matrix meshWorldMatrix{ meshState.mesh.worldMatrix };
+	const Matrix meshNormalMatrix{ meshState.mesh.normalMatrix };
+	const Matrix worldViewProjectionMatrix = meshWorldMatrix * frame.viewProjectionMatrix;
+	const Vector3 cameraOrigin{ frame.cameraOrigin };
+
+	std::vector<Vertex_Out>& vertices_out{ meshState.vertices_out };
+
+	// For the parallelization, i wanted existing slots to fill in the out vertices, hen
+	// Using pushback or emplace back made the order of vertices all messed up (and ended up breaking the 3D model)
+	vertices_out.resize(pMesh->vertices.size());
+	frame.statistics[m_JobSystem.GetCurrentThreadIndex()].statistics.verticesTransformed += pMesh->vertices.size();
+
+	// Multithread the vertex loop
+	m_JobSystem.ParallelFor(0u, (uint32_t)pMesh->vertices.size(), [&](uint32_t index)
+	{
+		{
+			const Vertex& vert{ pMesh->vertices[index] };
+
+			// World to camera (view space)
+			Vector4 newPosition = worldViewProjectionMatrix.TransformPoint({ vert.position, 1.0f });
+
+			// Perspective divide 
+			newPosition.x /= newPosition.w;
+			newPosition.y /= newPosition.w;
+			newPosition.z /= newPosition.w;
+
+			// Our coords are now in NDC space
+			// Multiply the normals and tangents with the normal matrix to convert them to worldspace
+			 //We only want to rotate them, so use transformvector, and normalize after
+			const Vector3 newNormal = meshNormalMatrix.TransformVector(vert.normal).Normalized();
+			const Vector3 newTangent = meshWorldMatrix.TransformVector(vert.tangent).Normalized();
+
+			// Calculate vert world position
+			const Vector3 vertPosition{ meshWorldMatrix.TransformPoint(vert.position) };
+
+			// Store the new position in the vertices out as Vertex out, because this one has a position 4 / vector4
+			Vertex_Out& outVert = vertices_out[index];
+			outVert.position = newPosition;
+			outVert.color = vert.color;
+			outVert.uv = vert.uv;
+			outVert.normal = newNormal;
+			outVert.tangent = newTangent;
+			outVert.viewDirection = { vertPosition - cameraOrigin };
+		}
+	});
+}
+
+void SoftwareRasterizer::BinTriangles(SoftwareFrame& frame, uint32_t chunkIndex) const
+{
+	DAE_PROFILE_SCOPE("TriangleSetup");
+
+	BinningChunk& chunk{ frame.binningChunks[chunkIndex] };
+	const SoftwareMeshState& meshState{ frame.meshes[chunk.meshIndex] };
+	const Mesh* pMesh{ meshState.mesh.pMesh };
+
+	chunk.triangles.clear();
+	chunk.tileBins.resize(m_SoftwareTiles.size());
+	for(std::vector<uint32_t>& tileBin : chunk.tileBins)
+		tileBin.clear();
+
+	int increment = 3;
+	if(pMesh->GetTopology() == PrimitiveTopology::TriangleStrip)
+		increment = 1;
+
+	// Counted here and added to the slot of the thread once, the slot is only touched at the end
+	uint32_t numDegenerate{ 0 };
+	uint32_t numDepthCulled{ 0 };
+	uint32_t numFrustumCulled{ 0 };
+	uint32_t numOutsideBand{ 0 };
+
+	for(uint32_t triangleIdx{ chunk.firstTriangle }; triangleIdx < chunk.lastTriangle; ++triangleIdx)
+	{
+		const uint32_t indiceIdx{ triangleIdx * increment };
+		// Get the vertices using the indice numbers
+		const uint32_t indiceA{ pMesh->indices[indiceIdx] };
+		const uint32_t indiceB{ pMesh->indices[indiceIdx + 1] };
+		const uint32_t indiceC{ pMesh->indices[indiceIdx + 2] };
+
+		Vertex_Out A{ meshState.vertices_out[indiceA] };
+		Vertex_Out B{ meshState.vertices_out[indiceB] };
+		Vertex_Out C{ meshState.vertices_out[indiceC] };
+
+		// If triangle strip, move only one position per itteration & inverse the direction on every odd loop
+
+		if(pMesh->GetTopology() == PrimitiveTopology::TriangleStrip)
+		{
+			// Check if least significant bit is 1 (odd number)
+			if((indiceIdx & 1) == 1)
+				std::swap(B, C);
+
+			// Check if any vertices of the triangle are the same (and thus the triangle has 0 area / should not be rendered)
+			if(indiceA == indiceB || indiceB == indiceC || indiceC == indiceA)
+			{
+				++numDegenerate;
+				continue;
+			}
+
+		}
+
+
+		// Do frustum culling
+		if(A.position.z < 0.0f || A.position.z > 1.0f
+			|| B.position.z < 0.0f || B.position.z > 1.0f
+			|| C.position.z < 0.0f || C.position.z > 1.0f)
+		{
+			++numDepthCulled;
+			continue;
+		}
+
+		const bool isOutsideX{ (A.position.x < -1.0f || A.position.x > 1.0f) && (B.position.x < -1.0f || B.position.x > 1.0f) && (C.position.x < -1.0f || C.position.x > 1.0f) };
+		const bool isOutsideY{ (A.position.y < -1.0f || A.position.y > 1.0f) && (B.position.y < -1.0f || B.position.y > 1.0f) && (C.position.y < -1.0f || C.position.y > 1.0f) };
+		if(isOutsideX || isOutsideY)
+		{
+			++numFrustumCulled;
+			continue;
+		}
+
+
+		// Convert from NDC to ScreenSpace
+		A.position.x = (A.position.x + 1) / 2.0f * m_Width; // Screen X
+		A.position.y = (1 - A.position.y) / 2.0f * m_Height; // Screen Y,
+		B.position.x = (B.position.x + 1) / 2.0f * m_Width; // Screen X
+		B.position.y = (1 - B.position.y) / 2.0f * m_Height; // Screen Y,
+		C.position.x = (C.position.x + 1) / 2.0f * m_Width; // Screen X
+		C.position.y = (1 - C.position.y) / 2.0f * m_Height; // Screen Y,
+
+		// Tiles the bounding box of the triangle overlaps
+		const float minX{ std::clamp(std::min(A.position.x, std::min(B.position.x, C.position.x)), 0.0f, float(m_Width - 1)) };
+		const float minY{ std::clamp(std::min(A.position.y, std::min(B.position.y, C.position.y)), 0.0f, float(m_Height - 1)) };
+		const float maxX{ std::clamp(std::max(A.position.x, std::max(B.position.x, C.position.x)), 0.0f, float(m_Width - 1)) };
+		const float maxY{ std::clamp(std::max(A.position.y, std::max(B.position.y, C.position.y)), 0.0f, float(m_Height - 1)) };
+
+		// Only the tile rows in the band of this frame
+		const int firstTileX{ int(minX) / SoftwareTile::Size };
+		const int firstTileY{ std::max(int(minY), frame.firstRow) / SoftwareTile::Size };
+		const int lastTileX{ int(maxX) / SoftwareTile::Size };
+		const int lastTileY{ std::min(int(maxY), frame.lastRow - 1) / SoftwareTile::Size };
+		if(firstTileY > lastTileY)
+		{
+			++numOutsideBand;
+			continue;
+		}
+
+		const uint32_t triangleIndex{ static_cast<uint32_t>(chunk.triangles.size()) };
+		chunk.triangles.push_back({ A, B, C });
+
+		for(int tileY{ firstTileY }; tileY <= lastTileY; ++tileY)
+		{
+			for(int tileX{ firstTileX }; tileX <= lastTileX; ++tileX)
+			{
+				chunk.tileBins[tileX + tileY * m_NumTilesX].push_back(triangleIndex);
+			}
+		}
+	}
+
+	SoftwarePipelineStatistics& statistics{ frame.statistics[m_JobSystem.GetCurrentThreadIndex()].statistics };
+	statistics.trianglesSubmitted += chunk.lastTriangle - chunk.firstTriangle;
+	statistics.trianglesDegenerate += numDegenerate;
+	statistics.trianglesDepthCulled += numDepthCulled;
+	statistics.trianglesFrustumCulled += numFrustumCulled;
+	statistics.trianglesOutsideBand += numOutsideBand;
+	statistics.trianglesBinned += chunk.triangles.size();
+}
+
+void SoftwareRasterizer::RasterTile(SoftwareFrame& frame, uint32_t tileIndex, RasterTriangleFunction rasterTriangle, const ColorRGB& clearColor) const
+{
+	const SoftwareTile& tile{ m_SoftwareTiles[tileIndex] };
+
+	// Only the rows of the band, rounded out to row pairs: the YUV resolve averages the chroma of both rows of a pair
+	// The rows outside of it are never resolved, so they are left as they are
+	const int firstRow{ std::max(tile.minY, frame.firstRow & ~1) };
+	const int lastRow{ std::min(tile.maxY, frame.lastRow + (frame.lastRow & 1)) };
+	const int firstIndex{ tile.GetLocalIndex(tile.minX, firstRow) };
+	const int numRowPixels{ (lastRow - firstRow) * SoftwareTile::Size };
+
+	// Clear the rows, they stay in cache for the raster right after
+	{
+		DAE_PROFILE_SCOPE("Clear");
+		std::fill_n(tile.GetRed() + firstIndex, numRowPixels, clearColor.r);
+		std::fill_n(tile.GetGreen() + firstIndex, numRowPixels, clearColor.g);
+		std::fill_n(tile.GetBlue() + firstIndex, numRowPixels, clearColor.b);
+		std::fill_n(tile.pDepth + firstIndex, numRowPixels, std::numeric_limits<float>::max());
+	}
+
+#ifdef DAE_PROFILING
+	const uint64_t rasterStartTicks{ Profiler::GetTicks() };
+	t_PixelShaderTicks = 0;
+#endif
+
+	// Chunks in submission order, one thread per tile so the depth test never races
+	SoftwarePipelineStatistics statistics{};
+	for(uint32_t chunkIndex{ 0 }; chunkIndex < frame.numBinningChunks; ++chunkIndex)
+	{
+		const BinningChunk& chunk{ frame.binningChunks[chunkIndex] };
+		const SoftwareMaterial& material{ frame.meshes[chunk.meshIndex].mesh.pMesh->GetMaterial() };
+		for(const uint32_t triangleIndex : chunk.tileBins[tileIndex])
+		{
+			const ScreenTriangle& triangle{ chunk.triangles[triangleIndex] };
+			(this->*rasterTriangle)(tile, firstRow, lastRow, material, triangle.A, triangle.B, triangle.C, statistics);
+		}
+	}
+
+	// Whatever got drawn left a depth behind, the tile is still in cache
+	// Only counted inside the band (not the rows rounded out to pairs), so the covered pixels never go past numPixels
+	if(statistics.pixelsPassed > 0)
+	{
+		const int firstBandIndex{ tile.GetLocalIndex(tile.minX, std::max(tile.minY, frame.firstRow)) };
+		const int lastBandIndex{ tile.GetLocalIndex(tile.minX, std::min(tile.maxY, frame.lastRow)) };
+		statistics.pixelsDrawn = std::count_if(tile.pDepth + firstBandIndex, tile.pDepth + lastBandIndex, [](float depth) { return depth != std::numeric_limits<float>::max(); });
+	}
+	frame.statistics[m_JobSystem.GetCurrentThreadIndex()].statistics.Add(statistics);
+
+#ifdef DAE_PROFILING
+	// One event per pixel shader call would flood the trace, their summed time shows nested at the start of the raster instead
+	Profiler::AddEvent("Raster", rasterStartTicks, Profiler::GetTicks());
+	Profiler::AddEvent("PixelShader", rasterStartTicks, rasterStartTicks + t_PixelShaderTicks);
+#endif
+}
+
+void SoftwareRasterizer::ResolveTile(uint32_t tileIndex, uint32_t* pTarget, int targetPitch, bool encodeSRGB, int firstRow, int lastRow) const
+{
+	const SoftwareTile& tile{ m_SoftwareTiles[tileIndex] };
+
+	const __m128i redShift{ _mm_cvtsi32_si128(int(m_PixelPacking.redShift)) };
+	const __m128i greenShift{ _mm_cvtsi32_si128(int(m_PixelPacking.greenShift)) };
+	const __m128i blueShift{ _mm_cvtsi32_si128(int(m_PixelPacking.blueShift)) };
+	const __m128i alphaBits{ _mm_set1_epi32(int(m_PixelPacking.alphaBits)) };
+
+	// Convert the tile rows 4 pixels at a time into the back buffer (or window surface)
+	// Tile rows are always Size floats long, so reading past the width of an edge tile stays inside the tile
+	const int tileWidth{ tile.maxX - tile.minX };
+	const int rowEnd{ std::min(tile.maxY, lastRow) };
+	for(int py{ std::max(tile.minY, firstRow) }; py < rowEnd; ++py)
+	{
+		const int rowIndex{ tile.GetLocalIndex(tile.minX, py) };
+		uint32_t* pRow{ pTarget + tile.minX + py * targetPitch };
+
+		for(int x{ 0 }; x < tileWidth; x += 4)
+		{
+			__m128i red{}, green{}, blue{};
+			ConvertToBytes(tile, rowIndex + x, encodeSRGB, red, green, blue);
+
+			const __m128i pixels{ _mm_or_si128(
+				_mm_or_si128(_mm_sll_epi32(red, redShift), _mm_sll_epi32(green, greenShift)),
+				_mm_or_si128(_mm_sll_epi32(blue, blueShift), alphaBits)) };
+
+			if(x + 4 <= tileWidth)
+			{
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(pRow + x), pixels);
+			}
+			else
+			{
+				alignas(16) uint32_t pixelLanes[4];
+				_mm_store_si128(reinterpret_cast<__m128i*>(pixelLanes), pixels);
+				std::copy_n(pixelLanes, tileWidth - x, pRow + x);
+			}
+		}
+	}
+}
+
+void SoftwareRasterizer::ResolveTileYUV(uint32_t tileIndex, const YUVTarget& target, bool encodeSRGB, int firstRow, int lastRow) const
+{
+	const SoftwareTile& tile{ m_SoftwareTiles[tileIndex] };
+
+	// BT.601 limited range from 0 - 255 channels, + 0.5 so the truncation rounds
+	const Floatx4 yOffset{ 16.5f }, uvOffset{ 128.5f };
+	const Floatx4 yRed{ 0.256788f }, yGreen{ 0.504129f }, yBlue{ 0.097906f };
+	const Floatx4 uRed{ -0.148223f }, uGreen{ -0.290993f }, uBlue{ 0.439216f };
+	const Floatx4 vRed{ 0.439216f }, vGreen{ -0.367788f }, vBlue{ -0.071427f };
+
+	// 4 lanes of 0 - 255 values to 4 bytes in the low 32 bits
+	const auto packBytes = [](const Floatx4& low, const Floatx4& high)
+	{
+		const __m128i words{ _mm_packs_epi32(_mm_cvttps_epi32(low.value), _mm_cvttps_epi32(high.value)) };
+		return _mm_packus_epi16(words, words);
+	};
+	const auto storeBytes = [](uint8_t* pDestination, __m128i bytes, int numBytes, int maxBytes)
+	{
+		if(numBytes <= maxBytes)
+		{
+			if(numBytes == 8)
+				_mm_storel_epi64(reinterpret_cast<__m128i*>(pDestination), bytes);
+			else
+			{
+				const int32_t fourBytes{ _mm_cvtsi128_si32(bytes) };
+				std::memcpy(pDestination, &fourBytes, sizeof(fourBytes));
+			}
+			return;
+		}
+
+		alignas(16) uint8_t byteLanes[16];
+		_mm_store_si128(reinterpret_cast<__m128i*>(byteLanes), bytes);
+		std::copy_n(byteLanes, std::min(numBytes, maxBytes), pDestination);
+	};
+
+	// Row pairs (tiles start on an even row), 8 pixels = 4 chroma samples at a time
+	// Tile rows are always Size floats long, so reading past the width of an edge tile stays inside the tile
+	const int tileWidth{ tile.maxX - tile.minX };
+	const bool hasOddWidth{ (tileWidth & 1) != 0 };  // Tiles start on an even column, only the last one of an odd width frame
+	const int rowEnd{ std::min(tile.maxY, lastRow) };
+	for(int py{ std::max(tile.minY, firstRow) & ~1 }; py < rowEnd; py += 2)
+	{
+		// An odd last row pairs up with itself
+		const int rows[2]{ py, std::min(py + 1, tile.maxY - 1) };
+		const bool writeRows[2]{ py >= firstRow, rows[1] != py && rows[1] < rowEnd };
+
+		for(int x{ 0 }; x < tileWidth; x += 8)
+		{
+			Floatx4 red[2][2]{}, green[2][2]{}, blue[2][2]{};  // [row][left / right 4 pixels]
+			for(int row{ 0 }; row < 2; ++row)
+			{
+				for(int half{ 0 }; half < 2; ++half)
+				{
+					__m128i redBytes{}, greenBytes{}, blueBytes{};
+					ConvertToBytes(tile, tile.GetLocalIndex(tile.minX, rows[row]) + x + half * 4, encodeSRGB, redBytes, greenBytes, blueBytes);
+					red[row][half] = _mm_cvtepi32_ps(redBytes);
+					green[row][half] = _mm_cvtepi32_ps(greenBytes);
+					blue[row][half] = _mm_cvtepi32_ps(blueBytes);
+				}
+
+				if(!writeRows[row])
+					continue;
+
+				const Floatx4 lumaLeft{ yOffset + red[row][0] * yRed + green[row][0] * yGreen + blue[row][0] * yBlue };
+				const Floatx4 lumaRight{ yOffset + red[row][1] * yRed + green[row][1] * yGreen + blue[row][1] * yBlue };
+				storeBytes(target.pY + size_t(rows[row]) * target.yPitch + tile.minX + x, packBytes(lumaLeft, lumaRight), 8, tileWidth - x);
+			}
+
+			// An odd last column pairs up with itself, the column right of it is padding that only holds the clear color
+			if(hasOddWidth && x + 8 > tileWidth)
+			{
+				const int lastLane{ tileWidth - 1 - x };
+				for(Floatx4 (*pChannel)[2] : { red, green, blue })
+				{
+					for(int row{ 0 }; row < 2; ++row)
+					{
+						alignas(16) float lanes[8];
+						pChannel[row][0].Store(lanes);
+						pChannel[row][1].Store(lanes + 4);
+						lanes[lastLane + 1] = lanes[lastLane];
+						pChannel[row][0] = Floatx4::Load(lanes);
+						pChannel[row][1] = Floatx4::Load(lanes + 4);
+					}
+				}
+			}
+
+			// Average of every 2x2 block: even + odd lanes of both rows
+			const auto average = [](const Floatx4 (&channel)[2][2])
+			{
+				Floatx4 sum{};
+				for(int row{ 0 }; row < 2; ++row)
+				{
+					sum += _mm_shuffle_ps(channel[row][0].value, channel[row][1].value, _MM_SHUFFLE(2, 0, 2, 0));
+					sum += _mm_shuffle_ps(channel[row][0].value, channel[row][1].value, _MM_SHUFFLE(3, 1, 3, 1));
+				}
+				return sum * 0.25f;
+			};
+			const Floatx4 blockRed{ average(red) }, blockGreen{ average(green) }, blockBlue{ average(blue) };
+			const Floatx4 u{ uvOffset + blockRed * uRed + blockGreen * uGreen + blockBlue * uBlue };
+			const Floatx4 v{ uvOffset + blockRed * vRed + blockGreen * vGreen + blockBlue * vBlue };
+
+			const size_t uvIndex{ size_t(py / 2) * target.uvPitch + (tile.minX + x) / 2 };
+			const int numSamples{ (tileWidth - x + 1) / 2 };
+			storeBytes(target.pU + uvIndex, packBytes(u, u), 4, numSamples);
+			storeBytes(target.pV + uvIndex, packBytes(v, v), 4, numSamples);
+		}
+	}
+}
+
+void SoftwareRasterizer::ConvertToBytes(const SoftwareTile& tile, int localIndex, bool encodeSRGB, __m128i& red, __m128i& green, __m128i& blue) const
+{
+	ColorRGBx4 color{ Floatx4::Load(tile.GetRed() + localIndex), Floatx4::Load(tile.GetGreen() + localIndex), Floatx4::Load(tile.GetBlue() + localIndex) };
+	color.MaxToOne();
+
+	if(encodeSRGB)
+	{
+		red = m_SRGBEncodeTable.Encode(color.r);
+		green = m_SRGBEncodeTable.Encode(color.g);
+		blue = m_SRGBEncodeTable.Encode(color.b);
+	}
+	else
+	{
+		// Truncate like the casts to uint8_t did
+		red = _mm_cvttps_epi32((Saturate(color.r) * 255.0f).value);
+		green = _mm_cvttps_epi32((Saturate(color.g) * 255.0f).value);
+		blue = _mm_cvttps_epi32((Saturate(color.b) * 255.0f).value);
+	}
+}
+
+SoftwareRasterizer::RasterTriangleFunction SoftwareRasterizer::SelectRasterTriangleFunction(const SoftwareRenderSettings& settings) const
+{
+	using CullModes = SoftwareRenderSettings::CullModes;
+	using ShadingModes = SoftwareRenderSettings::ShadingModes;
+
+	// Bounding box visualization ignores culling and shading, so it only has one permutation
+	if(settings.ShowBoundingBox)
+		return &SoftwareRasterizer::SoftwareRenderBoundingBox;
+
+	// Every permutation of the frame constant settings, layout: [cullMode][shadingMode][useNormalMap][showDepthBuffer]
+	static constexpr auto rasterTriangleFunctions = []<size_t... indices>(std::index_sequence<indices...>)
+	{
+		return std::array<RasterTriangleFunction, sizeof...(indices)>{
+			&SoftwareRasterizer::SoftwareRenderTriangle<CullModes(indices / 16), ShadingModes(indices / 4 % 4), bool(indices / 2 % 2), bool(indices % 2)>...
+		};
+	}(std::make_index_sequence<3 * 4 * 2 * 2>{});
+
+	const size_t index{
+		size_t(settings.CullMode) * 16 +
+		size_t(settings.ShadingMode) * 4 +
+		size_t(settings.UseNormalMap) * 2 +
+		size_t(settings.ShowDepthBuffer)
+	};
+
+	return rasterTriangleFunctions[index];
+}
+
+void SoftwareRasterizer::SoftwareRenderBoundingBox(const SoftwareTile& tile, int firstRow, int lastRow, const SoftwareMaterial& /*material*/, const Vertex_Out& A, const Vertex_Out& B, const Vertex_Out& C, SoftwarePipelineStatistics& statistics) const
+{
+	// Get the bounding box of the triangle (min max), only the part inside the rows of this tile
+	const int minX{ int(std::clamp(std::min(A.position.x, std::min(B.position.x, C.position.x)), float(tile.minX), float(tile.maxX))) };
+	const int minY{ int(std::clamp(std::min(A.position.y, std::min(B.position.y, C.position.y)), float(firstRow), float(lastRow))) };
+	const int maxX{ int(ceil(std::clamp(std::max(A.position.x, std::max(B.position.x, C.position.x)), float(tile.minX), float(tile.maxX)))) };
+	const int maxY{ int(ceil(std::clamp(std::max(A.position.y, std::max(B.position.y, C.position.y)), float(firstRow), float(lastRow)))) };
+
+	// No depth test or shading, the whole box gets written
+	++statistics.triangleTilesRasterized;
+	if(minX >= maxX || minY >= maxY)
+		++statistics.triangleTilesEmpty;
+	else
+		statistics.pixelsPassed += uint64_t(maxX - minX) * (maxY - minY);
+
+	// Render white pixels where bounding box is
+	for(int py = minY; py < maxY; ++py)
+	{
+		const int rowIndex{ tile.GetLocalIndex(minX, py) };
+		std::fill_n(tile.GetRed() + rowIndex, maxX - minX, 1.0f);
+		std::fill_n(tile.GetGreen() + rowIndex, maxX - minX, 1.0f);
+		std::fill_n(tile.GetBlue() + rowIndex, maxX - minX, 1.0f);
+	}
+}
+
+template<SoftwareRenderSettings::CullModes cullMode, SoftwareRenderSettings::ShadingModes shadingMode, bool useNormalMap, bool showDepthBuffer>
+void SoftwareRasterizer::SoftwareRenderTriangle(const SoftwareTile& tile, int firstRow, int lastRow, const SoftwareMaterial& material, const Vertex_Out& A, const Vertex_Out& B, const Vertex_Out& C, SoftwarePipelineStatistics& statistics) const
+{
+	using CullModes = SoftwareRenderSettings::CullModes;
+	using ShadingModes = SoftwareRenderSettings::ShadingModes;
+
+	// Only interpolate what the pixel shader of this permutation actually reads (vertex color is never used)
+	constexpr bool needsNormal{ !showDepthBuffer };
+	constexpr bool needsTangent{ needsNormal && useNormalMap };
+	constexpr bool needsUV{ needsNormal && (useNormalMap || shadingMode != ShadingModes::ObservedArea) };
+	constexpr bool needsViewDirection{ needsNormal && (shadingMode == ShadingModes::Combined || shadingMode == ShadingModes::Specular) };
+
+	// Define the edges of the screen triangle
+	const Vector2 edgeA{ A.position.GetXY(), B.position.GetXY() };
+	const Vector2 edgeB{ B.position.GetXY(), C.position.GetXY() };
+	const Vector2 edgeC{ C.position.GetXY(), A.position.GetXY() };
+
+	// Per triangle constants, hoisted out of the pixel loop
+	const float invTriangleArea{ ShadingMath::Reciprocal(Vector2::Cross(edgeA, -edgeC)) };
+	const float invWA{ ShadingMath::Reciprocal(A.position.w) };
+	const float invWB{ ShadingMath::Reciprocal(B.position.w) };
+	const float invWC{ ShadingMath::Reciprocal(C.position.w) };
+
+	// Kept exact, depth precision matters more than speed here
+	const float invZA{ 1.0f / A.position.z };
+	const float invZB{ 1.0f / B.position.z };
+	const float invZC{ 1.0f / C.position.z };
+
+	// Get the bounding box of the triangle (min max)
+	Vector2 bbMin;
+	bbMin.x = std::min(A.position.x, std::min(B.position.x, C.position.x));
+	bbMin.y = std::min(A.position.y, std::min(B.position.y, C.position.y));
+
+	Vector2 bbMax;
+	bbMax.x = std::max(A.position.x, std::max(B.position.x, C.position.x));
+	bbMax.y = std::max(A.position.y, std::max(B.position.y, C.position.y));
+
+	// Only the part inside the rows of this tile
+	bbMin.x = std::clamp(bbMin.x, float(tile.minX), float(tile.maxX));
+	bbMin.y = std::clamp(bbMin.y, float(firstRow), float(lastRow));
+
+	bbMax.x = std::clamp(bbMax.x, float(tile.minX), float(tile.maxX));
+	bbMax.y = std::clamp(bbMax.y, float(firstRow), float(lastRow));
+
+	const int minX{ int(bbMin.x) };
+	const int maxX{ int(ceil(bbMax.x)) };
+
+	// Pixel centers of a 4 pixel row segment, one per lane
+	const Floatx4 laneOffsets{ 0.5f, 1.5f, 2.5f, 3.5f };
+
+	// Kept in registers, added to the statistics once the triangle is done
+	int coveredLanes{ 0 };
+	uint32_t numPixelsTested{ 0 };
+	uint32_t numPixelsPassed{ 0 };
+	uint32_t numPixelShaderInvocations{ 0 };
+
+	for(int py = int(bbMin.y); py < int(ceil(bbMax.y)); ++py)
+	{
+		const Floatx4 pixelY{ float(py) + 0.5f };
+
+		for(int px = minX; px < maxX; px += 4)
+		{
+			const Floatx4 pixelX{ Floatx4{ float(px) } + laneOffsets };
+
+			// Get the signed areas of every edge (no division by 2 because triangle area isn't either, and we are only interested in percentage)
+			// Same as Vector2::Cross(edge, pixel - vertex), written out per component
+			const Floatx4 signedAreaParallelogramAB{ edgeA.x * (pixelY - A.position.y) - edgeA.y * (pixelX - A.position.x) };
+			const Floatx4 signedAreaParallelogramBC{ edgeB.x * (pixelY - B.position.y) - edgeB.y * (pixelX - B.position.x) };
+			const Floatx4 signedAreaParallelogramCA{ edgeC.x * (pixelY - C.position.y) - edgeC.y * (pixelX - C.position.x) };
+
+			Floatx4 isInside{};
+			if constexpr(cullMode == CullModes::BackFace)
+			{
+				isInside = (signedAreaParallelogramAB > 0.0f) & (signedAreaParallelogramBC > 0.0f) & (signedAreaParallelogramCA > 0.0f);
+			}
+			else if constexpr(cullMode == CullModes::FrontFace)
+			{
+				isInside = (signedAreaParallelogramAB <= 0.0f) & (signedAreaParallelogramBC <= 0.0f) & (signedAreaParallelogramCA <= 0.0f);
+			}
+			else
+			{
+				isInside = (signedAreaParallelogramAB >= 0.0f) & (signedAreaParallelogramBC >= 0.0f) & (signedAreaParallelogramCA >= 0.0f);  // Inside Back
+				// inside triangle either front or back (| "or's" the 2 together)
+				isInside = isInside | ((signedAreaParallelogramAB <= 0.0f) & (signedAreaParallelogramBC <= 0.0f) & (signedAreaParallelogramCA <= 0.0f)); // Inside Front
+			}
+
+			// Lanes past the bounding box never count as inside
+			const int lanesInBox{ (1 << std::min(maxX - px, 4)) - 1 };
+			int laneMask{ MoveMask(isInside) & lanesInBox };
+			if(laneMask == 0)
+				continue;
+			coveredLanes |= laneMask;
+
+			// Get the weights of each vertex
+			const Floatx4 weightA{ signedAreaParallelogramBC * invTriangleArea };
+			const Floatx4 weightB{ signedAreaParallelogramCA * invTriangleArea };
+			const Floatx4 weightC{ signedAreaParallelogramAB * invTriangleArea };
+
+			// Get the interpolated Z buffer value
+			const Floatx4 zBuffer{ 1.0f / (weightA * invZA + weightB * invZB + weightC * invZC) };
+			laneMask &= MoveMask((zBuffer >= 0.0f) & (zBuffer <= 1.0f));
+			numPixelsTested += std::popcount(uint32_t(laneMask));
+
+			// Check and write the depth buffer per lane
+			float depthLanes[4];
+			zBuffer.Store(depthLanes);
+			for(int lane{ 0 }; lane < 4; ++lane)
+			{
+				if((laneMask & (1 << lane)) == 0)
+					continue;
+
+				float& depth{ tile.pDepth[tile.GetLocalIndex(px + lane, py)] };
+				if(depthLanes[lane] >= depth)
+				{
+					laneMask &= ~(1 << lane);
+					continue;
+				}
+
+				depth = depthLanes[lane];
+			}
+
+			if(laneMask == 0)
+				continue;
+			numPixelsPassed += std::popcount(uint32_t(laneMask));
+
+			ColorRGBx4 finalColor{};
+			if constexpr(showDepthBuffer)
+			{
+				const float remapMin{ 0.970f };
+				const float remapMax{ 1.0f };
+
+				const Floatx4 depthColor{ (Clamp(zBuffer, remapMin, remapMax) - remapMin) / (remapMax - remapMin) };
+
+				finalColor = { depthColor, depthColor, depthColor };
+			}
+			else
+			{
+				// Perspective correct weights, so every attribute only needs a weighted sum
+				const Floatx4 wInterpolated{ ShadingMath::Reciprocal(weightA * invWA + weightB * invWB + weightC * invWC) };
+				const Floatx4 correctedWeightA{ weightA * invWA * wInterpolated };
+				const Floatx4 correctedWeightB{ weightB * invWB * wInterpolated };
+				const Floatx4 correctedWeightC{ weightC * invWC * wInterpolated };
+
+				Vertex_Outx4 pixels{};
+
+				if constexpr(needsUV)
+				{
+					// Get the interpolated UV
+					pixels.uv = A.uv * correctedWeightA + B.uv * correctedWeightB + C.uv * correctedWeightC;
+				}
+
+				if constexpr(needsNormal)
+				{
+					// Get the interpolated normal
+					pixels.normal = A.normal * correctedWeightA + B.normal * correctedWeightB + C.normal * correctedWeightC;
+					ShadingMath::Normalize(pixels.normal);
+				}
+
+				if constexpr(needsTangent)
+				{
+					// Get the interpolated tangent
+					pixels.tangent = A.tangent * correctedWeightA + B.tangent * correctedWeightB + C.tangent * correctedWeightC;
+					ShadingMath::Normalize(pixels.tangent);
+				}
+
+				if constexpr(needsViewDirection)
+				{
+					// Get the interpolated viewdirection
+					pixels.viewDirection = A.viewDirection * correctedWeightA + B.viewDirection * correctedWeightB + C.viewDirection * correctedWeightC;
+					ShadingMath::Normalize(pixels.viewDirection);
+				}
+
+				++numPixelShaderInvocations;
+				DAE_PROFILE_ACCUMULATE(t_PixelShaderTicks);
+				finalColor = PixelShader<shadingMode, useNormalMap>(material, pixels, laneMask);
+			}
+
+			// Write the visible lanes to the tile, still linear, the resolve normalizes and packs them
+			float redLanes[4], greenLanes[4], blueLanes[4];
+			finalColor.r.Store(redLanes);
+			finalColor.g.Store(greenLanes);
+			finalColor.b.Store(blueLanes);
+			for(int lane{ 0 }; lane < 4; ++lane)
+			{
+				if((laneMask & (1 << lane)) == 0)
+					continue;
+
+				const int index{ tile.GetLocalIndex(px + lane, py) };
+				tile.GetRed()[index] = redLanes[lane];
+				tile.GetGreen()[index] = greenLanes[lane];
+				tile.GetBlue()[index] = blueLanes[lane];
+			}
+		}
+	}
+
+	++statistics.triangleTilesRasterized;
+	if(coveredLanes == 0)
+		++statistics.triangleTilesEmpty;
+	statistics.pixelsTested += numPixelsTested;
+	statistics.pixelsPassed += numPixelsPassed;
+	statistics.pixelShaderInvocations += numPixelShaderInvocations;
+}
+
+template<SoftwareRenderSettings::ShadingModes shadingMode, bool useNormalMap>
+ColorRGBx4 SoftwareRasterizer::PixelShader(const SoftwareMaterial& material, const Vertex_Outx4& pixels, int laneMask) const
+{
+	using ShadingModes = SoftwareRenderSettings::ShadingModes;
+
+	constexpr bool needsDiffuse{ shadingMode == ShadingModes::Combined || shadingMode == ShadingModes::Diffuse };
+	constexpr bool needsSpecular{ shadingMode == ShadingModes::Combined || shadingMode == ShadingModes::Specular };
+
+	const Vector3x4 lightDirection{ m_SceneSettings.Light.Direction };
+
+	// Select normal based on settings
+	Vector3x4 currentNormal{ pixels.normal };
+	if constexpr(useNormalMap)
+	{
+		const ColorRGBx4 normalColorSample{ material.pNormalMap->Sample(pixels.uv, laneMask) };
+
+		// Calculate tangent space axis
+		const Vector3x4 binormal{ Vector3x4::Cross(pixels.normal, pixels.tangent) };
+
+		// Calculate normal in tangent space, transformed by the {tangent, binormal, normal} axis
+		const Vector3x4 tangentNormal{ ShadingMath::Normalized(Vector3x4{ normalColorSample.r * 2.0f - 1.0f, normalColorSample.g * 2.0f - 1.0f, normalColorSample.b * 2.0f - 1.0f }) };
+		currentNormal = ShadingMath::Normalized(pixels.tangent * tangentNormal.x + binormal * tangentNormal.y + pixels.normal * tangentNormal.z);
+	}
+
+	// Calculate observed area / lambert Cosine
+	const Floatx4 observedArea{ Vector3x4::Dot(currentNormal, -lightDirection) };
+
+	// Lanes facing away from the light stay black
+	const Floatx4 isLit{ observedArea >= 0.0f };
+	laneMask &= MoveMask(isLit);
+	if(laneMask == 0)
+		return {};
+
+	ColorRGBx4 finalColor{};
+	if constexpr(shadingMode == ShadingModes::ObservedArea)
+	{
+		finalColor = { observedArea, observedArea, observedArea };
+	}
+	else
+	{
+		const ColorRGBx4 lightRadiance{ m_SceneSettings.Light.Color * m_SceneSettings.Light.Intensity };
+
+		// Calculate lambert
+		ColorRGBx4 lambertDiffuse{};
+		if constexpr(needsDiffuse)
+		{
+			const ColorRGBx4 diffuseColorSample{ material.pDiffuseMap->Sample(pixels.uv, laneMask) };
+			lambertDiffuse = diffuseColorSample / PI;
+		}
+
+		// Calculate phong
+		ColorRGBx4 phongSpecular{};
+		if constexpr(needsSpecular)
+		{
+			const ColorRGBx4 specularColorSample{ material.pSpecularMap->Sample(pixels.uv, laneMask) };
+			const ColorRGBx4 glossinessColor{ material.pGlossinessMap->Sample(pixels.uv, laneMask) };
+
+			const Vector3x4 reflect{ lightDirection - (currentNormal * (2.0f * Vector3x4::Dot(currentNormal, lightDirection))) };
+			const Floatx4 RdotV{ Max(0.0f, Vector3x4::Dot(reflect, -pixels.viewDirection)) };
+			phongSpecular = specularColorSample * m_SpecularPowTable.Sample(RdotV, glossinessColor.r); // Glosinness map is greyscale, ro r g and b are the same
+		}
+
+		if constexpr(shadingMode == ShadingModes::Combined)
+			finalColor = ((lightRadiance * lambertDiffuse) + phongSpecular + ColorRGBx4{ m_SceneSettings.AmbientLight }) * observedArea;
+		else if constexpr(shadingMode == ShadingModes::Diffuse)
+			finalColor = lightRadiance * lambertDiffuse * observedArea;
+		else
+			finalColor = phongSpecular;
+	}
+
+	return Select(isLit, finalColor, ColorRGBx4{});
+}
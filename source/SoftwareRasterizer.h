@@ -0,0 +1,316 @@
+#pragma once
+#include "Math.h"
+#include "ShadingMath.h"
+#include "JobSystem.h"
+#include "TaskGraph.h"
+#include "Mesh.h"
+
+#include <cstdint>
+#include <vector>
+
+using namespace dae;
+
+// Software rasterizer, the CPU pipeline without any window or graphics API: vertex stage, binning, tile raster + pixel shader, resolve
+// It renders into any 32 bit pixel buffer, the front end decides where that goes (window, file, shared memory, ...)
+
+// Extra structs for the scene
+struct DirectionalLight
+{
+	Vector3 Direction{ .577f, -.577f, .577f};
+	float Intensity{ 7.f };
+	ColorRGB Color{ 1.0f, 1.0f, 1.0f };
+};
+
+struct SceneSettings
+{
+	DirectionalLight Light{};
+	ColorRGB AmbientLight{ 0.025f, 0.025f , 0.025f};
+	float Shininess{ 25.0f };  // Any value, the specular pow table grows with it and uses powf from about 360 on (see GlossPowTable)
+};
+
+// Settings of one software frame
+struct SoftwareRenderSettings
+{
+	enum class CullModes
+	{
+		BackFace=0,
+		FrontFace=1,
+		None=2,
+	};
+
+	enum class ShadingModes
+	{
+		Combined,
+		ObservedArea,
+		Diffuse,		// Includes ObservedArea
+		Specular		// Includes ObservedArea
+	};
+
+	CullModes CullMode = CullModes::BackFace;
+	ShadingModes ShadingMode = ShadingModes::Combined;
+	bool UseNormalMap = true;
+	bool ShowDepthBuffer = false;
+	bool ShowBoundingBox = false;
+	bool PipelinedFrames = false;  // Vertex + binning of the next frame overlaps with the raster of this one, 1 frame extra latency
+	bool SRGBOutput = false;  // Encode the linear shading result to sRGB when writing the pixels
+	ColorRGB ClearColor{ .39f, .39f, .39f };  // Linear, 0 - 1
+
+	// Band of rows this frame renders, LastRow exclusive (-1 = the bottom), the target rows outside of it are left alone
+	// Sort-first rendering: every renderer of the same frame gets its own band
+	int FirstRow{ 0 };
+	int LastRow{ -1 };
+};
+
+// Mesh state of one frame
+struct SoftwareMeshInstance
+{
+	const Mesh* pMesh{ nullptr };
+	Matrix worldMatrix{};
+	Matrix normalMatrix{};
+};
+
+// Everything a software frame reads from the scene
+struct SoftwareScene
+{
+	Matrix viewProjectionMatrix{};
+	Vector3 cameraOrigin{};
+	std::vector<SoftwareMeshInstance> meshes{};  // Only the ones that should be rendered, culling whole meshes is up to the caller
+};
+
+// The screen is split in tiles, every tile has its own color and depth buffer
+// Color stays linear float until the resolve, which normalizes, encodes and packs it into the pixel format
+struct SoftwareTile
+{
+	static constexpr int Size{ 64 };
+	static constexpr int NumPixels{ Size * Size };
+
+	// Pixel bounds on screen, max is exclusive
+	int minX{};
+	int minY{};
+	int maxX{};
+	int maxY{};
+
+	float* pColor{ nullptr };  // Planar: all red, then all green, then all blue
+	float* pDepth{ nullptr };
+
+	float* GetRed() const { return pColor; };
+	float* GetGreen() const { return pColor + NumPixels; };
+	float* GetBlue() const { return pColor + 2 * NumPixels; };
+
+	int GetLocalIndex(int px, int py) const { return (px - minX) + (py - minY) * Size; };
+};
+
+// Where the 8 bit channels go in a 32 bit target pixel, default is 0x00RRGGBB
+struct PixelPacking
+{
+	uint32_t redShift{ 16 };
+	uint32_t greenShift{ 8 };
+	uint32_t blueShift{ 0 };
+	uint32_t alphaBits{ 0 };  // Or'd into every pixel
+};
+
+// Planar 8 bit YUV 4:2:0 target (BT.601, limited range), for video encoders
+// The chroma planes are (width + 1) / 2 x (height + 1) / 2, every chroma sample is the average of its 2x2 pixels (of the ones inside the frame, at an odd edge)
+struct YUVTarget
+{
+	uint8_t* pY{ nullptr };
+	uint8_t* pU{ nullptr };
+	uint8_t* pV{ nullptr };
+	int yPitch{};  // Bytes
+	int uvPitch{};  // Bytes
+};
+
+// Counted work of one software frame, like the pipeline statistics query of D3D
+struct SoftwarePipelineStatistics
+{
+	uint64_t verticesTransformed{};
+
+	// Every triangle submitted ends up in exactly one of these
+	uint64_t trianglesSubmitted{};
+	uint64_t trianglesDegenerate{};  // Strip triangles that repeat a vertex
+	uint64_t trianglesDepthCulled{};  // A vertex in front of the near or behind the far plane
+	uint64_t trianglesFrustumCulled{};  // Every vertex outside of the screen left / right or above / below
+	uint64_t trianglesOutsideBand{};  // Only covers rows of another band
+	uint64_t trianglesBinned{};  // Passed all of the above
+
+	uint64_t triangleTilesRasterized{};  // A triangle counts once for every tile it's rastered in
+	uint64_t triangleTilesEmpty{};  // Covered no pixel center of the tile: facing the culled way, or thinner than a pixel
+
+	uint64_t pixelsTested{};  // Covered and inside the depth range, so depth tested
+	uint64_t pixelsPassed{};  // Passed the depth test, written and shaded
+	uint64_t pixelShaderInvocations{};  // One per 4 pixel row segment with a pixel that passed
+	uint64_t pixelsDrawn{};  // Passed for at least one triangle, so visible in the end
+	uint64_t numPixels{};  // Of the frame, only the band in distributed mode
+
+	// Times a visible pixel got written on average, 1 = no overdraw
+	float GetOverdraw() const { return pixelsDrawn > 0 ? float(double(pixelsPassed) / double(pixelsDrawn)) : 0.0f; };
+
+	void Add(const SoftwarePipelineStatistics& other)
+	{
+		verticesTransformed += other.verticesTransformed;
+		trianglesSubmitted += other.trianglesSubmitted;
+		trianglesDegenerate += other.trianglesDegenerate;
+		trianglesDepthCulled += other.trianglesDepthCulled;
+		trianglesFrustumCulled += other.trianglesFrustumCulled;
+		trianglesOutsideBand += other.trianglesOutsideBand;
+		trianglesBinned += other.trianglesBinned;
+		triangleTilesRasterized += other.triangleTilesRasterized;
+		triangleTilesEmpty += other.triangleTilesEmpty;
+		pixelsTested += other.pixelsTested;
+		pixelsPassed += other.pixelsPassed;
+		pixelShaderInvocations += other.pixelShaderInvocations;
+		pixelsDrawn += other.pixelsDrawn;
+		numPixels += other.numPixels;
+	};
+};
+
+// Statistics of one thread, on a cache line of its own so the threads never write to the same line
+struct alignas(64) SoftwareStatisticsSlot
+{
+	SoftwarePipelineStatistics statistics{};
+};
+
+// Triangle in screen space, ready to raster
+struct ScreenTriangle
+{
+	Vertex_Out A{};
+	Vertex_Out B{};
+	Vertex_Out C{};
+};
+
+// Mesh of a software frame, with the vertex output of that frame
+struct SoftwareMeshState
+{
+	SoftwareMeshInstance mesh{};
+	std::vector<Vertex_Out> vertices_out{};
+};
+
+// A range of triangles of one mesh, set up and sorted into the tiles they overlap by one job
+struct BinningChunk
+{
+	static constexpr uint32_t NumTriangles{ 512 };
+
+	uint32_t meshIndex{};  // Into SoftwareFrame::meshes
+	uint32_t firstTriangle{};
+	uint32_t lastTriangle{};  // Exclusive
+
+	std::vector<ScreenTriangle> triangles{};  // Only the ones that passed culling
+	std::vector<std::vector<uint32_t>> tileBins{};  // Per tile, indices into triangles
+};
+
+// Everything of one software frame up to the tiles, there are 2 of these so the next frame can be set up while this one rasters
+struct SoftwareFrame
+{
+	explicit SoftwareFrame(JobSystem& jobSystem) : geometryGraph{ jobSystem }, statistics(jobSystem.GetNumThreads()) {};
+
+	// Copied from the scene
+	Matrix viewProjectionMatrix{};
+	Vector3 cameraOrigin{};
+	std::vector<SoftwareMeshState> meshes{};
+	uint32_t numMeshes{};  // In use this frame, the others keep their memory for later frames
+
+	// Band of rows of this frame (LastRow exclusive), from the settings
+	int firstRow{};
+	int lastRow{};
+
+	std::vector<BinningChunk> binningChunks{};
+	uint32_t numBinningChunks{};  // In use this frame, the others keep their memory for later frames
+
+	// Vertex and binning tasks of this frame
+	TaskGraph geometryGraph;
+	bool isGeometryStarted{ false };
+
+	// Per thread (JobSystem::GetCurrentThreadIndex), added up once the frame is rastered
+	std::vector<SoftwareStatisticsSlot> statistics{};
+};
+
+class SoftwareRasterizer final
+{
+public:
+	// jobSystem runs the frame tasks and has to outlive the rasterizer
+	SoftwareRasterizer(int width, int height, JobSystem& jobSystem, const SceneSettings& sceneSettings = {}, const PixelPacking& pixelPacking = {});
+
+	~SoftwareRasterizer();
+	SoftwareRasterizer(const SoftwareRasterizer&) = delete;
+	SoftwareRasterizer& operator=(const SoftwareRasterizer&) = delete;
+	SoftwareRasterizer(SoftwareRasterizer&&) = delete;
+	SoftwareRasterizer& operator=(SoftwareRasterizer&&) = delete;
+
+	// Renders the scene into pTarget (width x height, pitch in pixels), returns false when there was no frame to show yet (pipelined mode)
+	// The meshes are read until their frame is rastered, in pipelined mode that is during the next Render
+	// pYUVTarget also gets the frame as YUV, converted by the same tile jobs that write pTarget. pTarget can be nullptr when YUV is all that's needed
+	bool Render(const SoftwareScene& scene, const SoftwareRenderSettings& settings, uint32_t* pTarget, int targetPitch, const YUVTarget* pYUVTarget = nullptr);
+
+	// Waits until the geometry of a pipelined frame stopped reading the meshes
+	void Wait();
+
+	// Clears pTarget with every tile written by the thread that owns it, so its pages end up on the NUMA node of that thread
+	void FirstTouch(uint32_t* pTarget, int targetPitch);
+
+	// Copies the depth of the last frame Render wrote into pTarget (width x height, pitch in floats)
+	// Interpolated z of the closest triangle, FLT_MAX where nothing got drawn. Only the rows of that frame's band are valid
+	void CopyDepth(float* pTarget, int targetPitch) const;
+
+	// Of the last frame Render wrote into the target
+	const SoftwarePipelineStatistics& GetStatistics() const { return m_Statistics; };
+
+	int GetWidth() const { return m_Width; };
+	int GetHeight() const { return m_Height; };
+	const PixelPacking& GetPixelPacking() const { return m_PixelPacking; };
+
+private:
+	// Raster + shade permutation for one triangle, selected once per frame from the render settings
+	// Only rows firstRow - lastRow (exclusive) of the tile get rastered
+	using RasterTriangleFunction = void(SoftwareRasterizer::*)(const SoftwareTile& tile, int firstRow, int lastRow, const SoftwareMaterial& material, const Vertex_Out& A, const Vertex_Out& B, const Vertex_Out& C, SoftwarePipelineStatistics& statistics) const;
+
+	int m_Width{};
+	int m_Height{};
+
+	JobSystem& m_JobSystem;
+	SceneSettings m_SceneSettings{};
+	PixelPacking m_PixelPacking{};
+
+	std::vector<SoftwareTile> m_SoftwareTiles{};
+	int m_NumTilesX{};
+	int m_NumTilesY{};
+	SoftwareFrame* m_pSoftwareFrames[2]{};
+	uint32_t m_SoftwareFrameIndex{ 0 };  // Frame the next render sets up
+	ShadingMath::GlossPowTable m_SpecularPowTable{};  // pow(RdotV, gloss * shininess)
+	ShadingMath::SRGBEncodeTable m_SRGBEncodeTable{};
+	SoftwarePipelineStatistics m_Statistics{};
+
+	// Copies the camera, mesh state and band of rows the frame needs
+	void SetupSoftwareFrame(SoftwareFrame& frame, const SoftwareScene& scene, const SoftwareRenderSettings& settings) const;
+
+	// Frame task graph stages: vertex (per mesh) -> binning (per chunk of triangles) -> raster (per tile) -> resolve (per tile)
+	// The geometry graph (vertex + binning) runs on its own, so in pipelined mode it can overlap with the tiles of the previous frame
+	void StartSoftwareGeometry(SoftwareFrame& frame) const;
+	void RenderSoftwareTiles(SoftwareFrame& frame, const SoftwareRenderSettings& settings, uint32_t* pTarget, int targetPitch, const YUVTarget* pYUVTarget) const;
+	// Adds up the thread slots of a rastered frame into m_Statistics
+	void MergeStatistics(const SoftwareFrame& frame);
+
+	void VertexTransformationFunction(SoftwareFrame& frame, uint32_t meshIndex) const;
+	void BinTriangles(SoftwareFrame& frame, uint32_t chunkIndex) const;
+	void RasterTile(SoftwareFrame& frame, uint32_t tileIndex, RasterTriangleFunction rasterTriangle, const ColorRGB& clearColor) const;
+	void ResolveTile(uint32_t tileIndex, uint32_t* pTarget, int targetPitch, bool encodeSRGB, int firstRow, int lastRow) const;
+	void ResolveTileYUV(uint32_t tileIndex, const YUVTarget& target, bool encodeSRGB, int firstRow, int lastRow) const;
+
+	// 4 pixels of a tile row as 0 - 255 channels, the way the resolve writes them
+	void ConvertToBytes(const SoftwareTile& tile, int localIndex, bool encodeSRGB, __m128i& red, __m128i& green, __m128i& blue) const;
+
+	// Tiles are handed out in contiguous blocks, the owner allocates (first touches) their memory and gets their jobs first
+	// With pinned workers this keeps the pages of a tile on the NUMA node of the thread that works on it
+	int GetTileOwner(uint32_t tileIndex) const;
+	bool IsTileOwner(uint32_t tileIndex, uint32_t threadIndex) const;
+	void AllocateTiles(uint32_t threadIndex);
+
+	RasterTriangleFunction SelectRasterTriangleFunction(const SoftwareRenderSettings& settings) const;
+	void SoftwareRenderBoundingBox(const SoftwareTile& tile, int firstRow, int lastRow, const SoftwareMaterial& material, const Vertex_Out& A, const Vertex_Out& B, const Vertex_Out& C, SoftwarePipelineStatistics& statistics) const;
+
+	template<SoftwareRenderSettings::CullModes cullMode, SoftwareRenderSettings::ShadingModes shadingMode, bool useNormalMap, bool showDepthBuffer>
+	void SoftwareRenderTriangle(const SoftwareTile& tile, int firstRow, int lastRow, const SoftwareMaterial& material, const Vertex_Out& A, const Vertex_Out& B, const Vertex_Out& C, SoftwarePipelineStatistics& statistics) const;
+
+	// Software pixel shader, shades a 4 pixel row segment at once (only the lanes in laneMask are valid)
+	template<SoftwareRenderSettings::ShadingModes shadingMode, bool useNormalMap>
+	ColorRGBx4 PixelShader(const SoftwareMaterial& material, const Vertex_Outx4& pixels, int laneMask) const;
+};
@@ -0,0 +1,74 @@
+#include "TaskGraph.h"
+#include "JobSystem.h"
+
+#include <cassert>
+
+TaskGraph::TaskId TaskGraph::AddTask(std::function<void()> function, int preferredWorker)
+{
+	Task& task{ m_Tasks.emplace_back() };
+	task.function = std::move(function);
+	task.preferredWorker = preferredWorker;
+
+	return static_cast<TaskId>(m_Tasks.size() - 1);
+}
+
+void TaskGraph::AddDependency(TaskId before, TaskId after)
+{
+	assert(before < m_Tasks.size() && after < m_Tasks.size() && before != after);
+
+	m_Tasks[before].successors.push_back(after);
+	++m_Tasks[after].numDependencies;
+}
+
+void TaskGraph::Run()
+{
+	Start();
+	Wait();
+}
+
+void TaskGraph::Start()
+{
+	assert(m_PendingTasks.load() == 0 && "Starting a TaskGraph that is still running");
+	if(m_Tasks.empty())
+		return;
+
+	// Every task counts until it finished, successors get scheduled before their parent counts down so this never hits 0 early
+	m_PendingTasks.store(GetNumTasks(), std::memory_order_relaxed);
+	for(Task& task : m_Tasks)
+		task.remainingDependencies.store(task.numDependencies, std::memory_order_relaxed);
+
+	for(TaskId id{ 0 }; id < GetNumTasks(); ++id)
+	{
+		if(m_Tasks[id].numDependencies == 0)
+			ScheduleTask(id);
+	}
+}
+
+void TaskGraph::Wait()
+{
+	m_JobSystem.Wait(m_PendingTasks);
+}
+
+void TaskGraph::Clear()
+{
+	assert(m_PendingTasks.load() == 0 && "Clearing a TaskGraph that is still running");
+	m_Tasks.clear();
+}
+
+void TaskGraph::ScheduleTask(TaskId id)
+{
+	m_JobSystem.Schedule([this, id]() { RunTask(id); }, &m_PendingTasks, m_Tasks[id].preferredWorker);
+}
+
+void TaskGraph::RunTask(TaskId id)
+{
+	Task& task{ m_Tasks[id] };
+	task.function();
+
+	// Last finished dependency releases the successor
+	for(TaskId successor : task.successors)
+	{
+		if(m_Tasks[successor].remainingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			ScheduleTask(successor);
+	}
+}
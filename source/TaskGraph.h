@@ -0,0 +1,61 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <vector>
+
+class JobSystem;
+
+// Tasks with dependencies, run on a JobSystem
+// A task gets scheduled as soon as all tasks it depends on finished, there are no barriers between "stages"
+class TaskGraph final
+{
+public:
+	using TaskId = uint32_t;
+
+	explicit TaskGraph(JobSystem& jobSystem) : m_JobSystem{ jobSystem } {};
+
+	~TaskGraph() = default;
+	TaskGraph(const TaskGraph&) = delete;
+	TaskGraph& operator=(const TaskGraph&) = delete;
+	TaskGraph(TaskGraph&&) = delete;
+	TaskGraph& operator=(TaskGraph&&) = delete;
+
+	// preferredWorker: see JobSystem::Schedule
+	TaskId AddTask(std::function<void()> function, int preferredWorker = -1);
+
+	// after only starts once before finished
+	void AddDependency(TaskId before, TaskId after);
+
+	// Runs every task and returns once all of them finished, the calling thread helps out in the meantime
+	// The graph can be run again afterwards
+	void Run();
+
+	// Run in 2 parts: Start schedules the tasks and returns right away, Wait returns once all of them finished
+	// Wait on a graph that is not running returns right away
+	void Start();
+	void Wait();
+
+	// Removes all tasks
+	void Clear();
+
+	uint32_t GetNumTasks() const { return static_cast<uint32_t>(m_Tasks.size()); };
+
+private:
+	struct Task
+	{
+		std::function<void()> function{};
+		int preferredWorker{ -1 };
+		std::vector<TaskId> successors{};
+		uint32_t numDependencies{ 0 };
+		std::atomic<uint32_t> remainingDependencies{ 0 };
+	};
+
+	JobSystem& m_JobSystem;
+	std::deque<Task> m_Tasks{};  // Deque, tasks hold an atomic so they cant be moved around
+	std::atomic<uint32_t> m_PendingTasks{ 0 };
+
+	void ScheduleTask(TaskId id);
+	void RunTask(TaskId id);
+};
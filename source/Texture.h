@@ -1,11 +1,15 @@
 #pragma once
 
-#include <SDL_surface.h>
-#include <string>
+#include <cstdint>
+#include <vector>
 #include "ColorRGB.h"
+#include "ColorRGBx4.h"
+#include "Vector2x4.h"
 
 using namespace dae;
 
+// Texture of the software rasterizer, just the pixels in memory
+// Loading the image file is up to the front end (SDL_image, libpng, ...), the DirectX copy lives in HardwareTexture
 class Texture final
 {
 public:
@@ -16,22 +20,22 @@ public:
 		Clamp,
 		Border
 	};
-	~Texture();
+	~Texture() = default;
 
-	static Texture* LoadFromFile(ID3D11Device* pDevice, const std::string& path);
-	ID3D11ShaderResourceView* GetShaderResourceView() const { return m_pShaderResourceView; };
+	// pPixels: width * height pixels without padding, 8 bits per channel with red in the lowest byte (RGBA in memory), gets copied
+	static Texture* Create(int width, int height, const uint32_t* pPixels);
+
+	int GetWidth() const { return m_Width; };
+	int GetHeight() const { return m_Height; };
+	const uint32_t* GetPixels() const { return m_Pixels.data(); };
 	
 	ColorRGB Sample(const Vector2& uv, UVMode uvMode = UVMode::Wrap) const;
+	ColorRGBx4 Sample(const Vector2x4& uv, int laneMask, UVMode uvMode = UVMode::Wrap) const;  // Only samples the lanes set in laneMask
 
 private:
-	Texture(ID3D11Device* pDevice, SDL_Surface* pSurface);
-
-	// Software
-	SDL_Surface* m_pSurface{ nullptr };
-	uint32_t* m_pSurfacePixels{ nullptr };
+	Texture(int width, int height, const uint32_t* pPixels);
 
-	// DirectX
-	ID3D11Texture2D* m_pResource{};
-	ID3D11ShaderResourceView* m_pShaderResourceView{};
+	int m_Width{};
+	int m_Height{};
+	std::vector<uint32_t> m_Pixels{};
 };
-
@@ -0,0 +1,117 @@
+#include "ThroughputRasterizer.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <cassert>
+
+ThroughputRasterizer::ThroughputRasterizer(int width, int height, const ThroughputSettings& settings, const SceneSettings& sceneSettings, const PixelPacking& pixelPacking):
+	m_Width{ width },
+	m_Height{ height },
+	m_WorkersPerSlot{ static_cast<uint32_t>(std::max(0, settings.WorkersPerSlot)) },
+	m_PinThreads{ settings.PinThreads },
+	m_SceneSettings{ sceneSettings },
+	m_PixelPacking{ pixelPacking }
+{
+	assert(m_Width > 0 && m_Height > 0);
+
+	uint32_t numSlots{};
+	if(settings.NumSlots > 0)
+		numSlots = static_cast<uint32_t>(settings.NumSlots);
+	else
+		numSlots = std::max(1u, std::thread::hardware_concurrency() / (m_WorkersPerSlot + 1));
+
+	m_Slots.reserve(numSlots);
+	for(uint32_t slotIndex{ 0 }; slotIndex < numSlots; ++slotIndex)
+		m_Slots.emplace_back(&ThroughputRasterizer::SlotLoop, this, slotIndex);
+
+	// Ready to render once every slot has its rasterizer
+	std::unique_lock<std::mutex> lock{ m_Mutex };
+	m_Condition.wait(lock, [this]() { return m_NumReadySlots == GetNumSlots(); });
+}
+
+ThroughputRasterizer::~ThroughputRasterizer()
+{
+	{
+		std::lock_guard<std::mutex> lock{ m_Mutex };
+		m_IsStopping = true;
+	}
+	m_Condition.notify_all();
+
+	for(std::thread& slot : m_Slots)
+		slot.join();
+}
+
+void ThroughputRasterizer::RenderFrames(uint32_t numFrames, const SoftwareRenderSettings& settings, const SceneFunction& getScene, const FrameFunction& onFrame)
+{
+	{
+		std::lock_guard<std::mutex> lock{ m_Mutex };
+		assert(m_NumActiveSlots == 0 && "RenderFrames is not reentrant");
+
+		m_NumFrames = numFrames;
+		m_RenderSettings = settings;
+		m_RenderSettings.PipelinedFrames = false;
+		m_pGetScene = &getScene;
+		m_pOnFrame = &onFrame;
+		m_NextFrame.store(0, std::memory_order_relaxed);
+
+		m_NumActiveSlots = GetNumSlots();
+		++m_BatchIndex;
+	}
+	m_Condition.notify_all();
+
+	std::unique_lock<std::mutex> lock{ m_Mutex };
+	m_Condition.wait(lock, [this]() { return m_NumActiveSlots == 0; });
+
+	m_pGetScene = nullptr;
+	m_pOnFrame = nullptr;
+}
+
+void ThroughputRasterizer::SlotLoop(uint32_t slotIndex)
+{
+	// Slot thread is the main thread of its job system, its workers take the cores right after it
+	JobSystemSettings jobSystemSettings{};
+	jobSystemSettings.NumWorkers = static_cast<int>(m_WorkersPerSlot);
+	jobSystemSettings.PinWorkers = m_PinThreads;
+	jobSystemSettings.ReserveMainCore = m_PinThreads;
+	jobSystemSettings.FirstCore = static_cast<int>(slotIndex * (m_WorkersPerSlot + 1));
+
+	JobSystem jobSystem{ jobSystemSettings };
+	SoftwareRasterizer rasterizer{ m_Width, m_Height, jobSystem, m_SceneSettings, m_PixelPacking };
+	std::vector<uint32_t> pixels(size_t(m_Width) * m_Height);
+	rasterizer.FirstTouch(pixels.data(), m_Width);
+	SoftwareScene scene{};
+
+	{
+		std::lock_guard<std::mutex> lock{ m_Mutex };
+		++m_NumReadySlots;
+	}
+	m_Condition.notify_all();
+
+	uint32_t batchIndex{ 0 };
+	while(true)
+	{
+		{
+			std::unique_lock<std::mutex> lock{ m_Mutex };
+			m_Condition.wait(lock, [this, batchIndex]() { return m_IsStopping || m_BatchIndex != batchIndex; });
+			if(m_IsStopping)
+				break;
+			batchIndex = m_BatchIndex;
+		}
+
+		// Next frame nobody took yet, until there are none left
+		for(uint32_t frameIndex{ m_NextFrame.fetch_add(1, std::memory_order_relaxed) }; frameIndex < m_NumFrames; frameIndex = m_NextFrame.fetch_add(1, std::memory_order_relaxed))
+		{
+			(*m_pGetScene)(slotIndex, frameIndex, scene);
+			rasterizer.Render(scene, m_RenderSettings, pixels.data(), m_Width);
+			(*m_pOnFrame)(slotIndex, frameIndex, pixels.data(), m_Width);
+		}
+
+		bool isLastSlot{};
+		{
+			std::lock_guard<std::mutex> lock{ m_Mutex };
+			isLastSlot = --m_NumActiveSlots == 0;
+		}
+		if(isLastSlot)
+			m_Condition.notify_all();
+	}
+}
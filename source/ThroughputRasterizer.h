@@ -0,0 +1,81 @@
+#pragma once
+#include "SoftwareRasterizer.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Settings of the frame slots
+struct ThroughputSettings
+{
+	// Frames rendering at the same time, -1 = as many as fit on the hardware threads
+	int NumSlots{ -1 };
+
+	// Workers every frame gets on top of its slot thread, 0 = every frame renders on one thread (no job overhead at all)
+	int WorkersPerSlot{ 0 };
+
+	// Pin every slot (its thread + workers) to a range of cores of its own
+	bool PinThreads{ false };
+};
+
+// Throughput mode for offline jobs: instead of spreading one frame over all cores, several independent frames render at once
+// Every slot is a thread with its own SoftwareRasterizer (color + depth tiles), target buffer and JobSystem (its subset of the workers)
+// The slots share the meshes and textures, which are only read while rendering
+// Small frames (640x480, a few thousand triangles) don't have enough work to keep all cores busy, many of them at once do
+class ThroughputRasterizer final
+{
+public:
+	// Fills the scene of frameIndex, called on the thread of slotIndex right before it renders the frame
+	using SceneFunction = std::function<void(uint32_t slotIndex, uint32_t frameIndex, SoftwareScene& scene)>;
+	// Rendered pixels of frameIndex (width x height, pitch in pixels), only valid during the call
+	using FrameFunction = std::function<void(uint32_t slotIndex, uint32_t frameIndex, const uint32_t* pPixels, int pitch)>;
+
+	ThroughputRasterizer(int width, int height, const ThroughputSettings& settings = {}, const SceneSettings& sceneSettings = {}, const PixelPacking& pixelPacking = {});
+
+	~ThroughputRasterizer();
+	ThroughputRasterizer(const ThroughputRasterizer&) = delete;
+	ThroughputRasterizer& operator=(const ThroughputRasterizer&) = delete;
+	ThroughputRasterizer(ThroughputRasterizer&&) = delete;
+	ThroughputRasterizer& operator=(ThroughputRasterizer&&) = delete;
+
+	// Renders frames 0 to numFrames - 1, a slot takes the next frame as soon as it finished its previous one, so they finish out of order
+	// getScene and onFrame run on all slot threads at the same time, each for a different frame
+	// Returns once every frame went through onFrame. PipelinedFrames is ignored, the slots already overlap
+	void RenderFrames(uint32_t numFrames, const SoftwareRenderSettings& settings, const SceneFunction& getScene, const FrameFunction& onFrame);
+
+	uint32_t GetNumSlots() const { return static_cast<uint32_t>(m_Slots.size()); };
+	uint32_t GetNumThreads() const { return GetNumSlots() * (m_WorkersPerSlot + 1); };
+	int GetWidth() const { return m_Width; };
+	int GetHeight() const { return m_Height; };
+
+private:
+	int m_Width{};
+	int m_Height{};
+	uint32_t m_WorkersPerSlot{};
+	bool m_PinThreads{};
+	SceneSettings m_SceneSettings{};
+	PixelPacking m_PixelPacking{};
+
+	std::vector<std::thread> m_Slots{};
+
+	// The batch the slots are working on, only changed while no slot is active
+	uint32_t m_NumFrames{};
+	SoftwareRenderSettings m_RenderSettings{};
+	const SceneFunction* m_pGetScene{ nullptr };
+	const FrameFunction* m_pOnFrame{ nullptr };
+	std::atomic<uint32_t> m_NextFrame{ 0 };
+
+	std::mutex m_Mutex{};
+	std::condition_variable m_Condition{};
+	uint32_t m_BatchIndex{ 0 };  // Goes up for every RenderFrames, wakes the slots
+	uint32_t m_NumActiveSlots{ 0 };
+	uint32_t m_NumReadySlots{ 0 };
+	bool m_IsStopping{ false };
+
+	// Everything of a slot is created on its own thread: pinned before it allocates, so its memory ends up next to its cores
+	void SlotLoop(uint32_t slotIndex);
+};
@@ -1,29 +1,61 @@
-#include "pch.h"
 #include "Timer.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+namespace
+{
+	// Steady clock instead of the SDL performance counter, so the timer works without SDL
+	// Nanoseconds, whatever the period of the clock
+	uint64_t GetPerformanceCounter()
+	{
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+
+	constexpr double SecondsPerCount{ 1e-9 };
+
+	// Nearest rank of a sorted range
+	uint64_t GetPercentile(const uint64_t* pSorted, uint32_t count, double percentile)
+	{
+		const uint32_t rank{ std::max(1u, static_cast<uint32_t>(percentile * count + 0.999999)) };
+		return pSorted[std::min(rank, count) - 1];
+	}
+
+	float ToMilliseconds(uint64_t nanoseconds)
+	{
+		return static_cast<float>(static_cast<double>(nanoseconds) * 1e-6);
+	}
+}
+
 namespace dae
 {
-	Timer::Timer()
+	Timer::~Timer()
 	{
-		const uint64_t countsPerSecond = SDL_GetPerformanceFrequency();
-		m_SecondsPerCount = 1.0f / static_cast<float>(countsPerSecond);
+		CloseTelemetry();
 	}
 
 	void Timer::Reset()
 	{
-		const uint64_t currentTime = SDL_GetPerformanceCounter();
+		const uint64_t currentTime = GetPerformanceCounter();
 
 		m_BaseTime = currentTime;
 		m_PreviousTime = currentTime;
+		m_PausedTime = 0;
 		m_StopTime = 0;
 		m_FPSTimer = 0.0f;
 		m_FPSCount = 0;
 		m_IsStopped = false;
+
+		m_NumFrames = 0;
+		std::fill_n(m_HistogramBuckets, NumHistogramBuckets, 0u);
+		m_MaxFrameNs = 0;
+		m_RollingFrameTimes = {};
 	}
 
 	void Timer::Start()
 	{
-		const uint64_t startTime = SDL_GetPerformanceCounter();
+		const uint64_t startTime = GetPerformanceCounter();
 
 		if (m_IsStopped)
 		{
@@ -41,25 +73,25 @@ namespace dae
 		{
 			m_FPS = 0;
 			m_ElapsedTime = 0.0f;
-			m_TotalTime = static_cast<float>(((m_StopTime - m_PausedTime) - m_BaseTime) * m_BaseTime);
+			m_TotalTime = static_cast<float>(static_cast<double>((m_StopTime - m_PausedTime) - m_BaseTime) * SecondsPerCount);
 			return;
 		}
 
-		const uint64_t currentTime = SDL_GetPerformanceCounter();
+		const uint64_t currentTime = GetPerformanceCounter();
 		m_CurrentTime = currentTime;
 
-		m_ElapsedTime = static_cast<float>(m_CurrentTime - m_PreviousTime) * m_SecondsPerCount;
+		// The steady clock never goes back
+		const uint64_t elapsedNs = m_CurrentTime - m_PreviousTime;
+		m_ElapsedTime = static_cast<float>(static_cast<double>(elapsedNs) * SecondsPerCount);
 		m_PreviousTime = m_CurrentTime;
-
-		if (m_ElapsedTime < 0.0f)
-			m_ElapsedTime = 0.0f;
+		RecordFrame(elapsedNs);
 
 		if (m_ForceElapsedUpperBound && m_ElapsedTime > m_ElapsedUpperBound)
 		{
 			m_ElapsedTime = m_ElapsedUpperBound;
 		}
 
-		m_TotalTime = static_cast<float>(m_CurrentTime - m_PausedTime - m_BaseTime) * m_SecondsPerCount;
+		m_TotalTime = static_cast<float>(static_cast<double>(m_CurrentTime - m_PausedTime - m_BaseTime) * SecondsPerCount);
 
 		//FPS LOGIC
 		m_FPSTimer += m_ElapsedTime;
@@ -68,6 +100,8 @@ namespace dae
 		{
 			m_dFPS = static_cast<float>(m_FPSCount) / m_FPSTimer;
 			m_FPS = m_FPSCount;
+			UpdateRollingFrameTimes(m_FPSCount);
+			WriteTelemetry();
 			m_FPSCount = 0;
 			m_FPSTimer = 0.0f;
 		}
@@ -77,10 +111,107 @@ namespace dae
 	{
 		if (!m_IsStopped)
 		{
-			const uint64_t currentTime = SDL_GetPerformanceCounter();
+			const uint64_t currentTime = GetPerformanceCounter();
 
 			m_StopTime = currentTime;
 			m_IsStopped = true;
 		}
 	}
-}
\ No newline at end of file
+
+	FrameTimeStatistics Timer::GetTotalFrameTimes() const
+	{
+		FrameTimeStatistics statistics{};
+		statistics.numFrames = m_NumFrames;
+		statistics.maxMs = ToMilliseconds(m_MaxFrameNs);
+		if (m_NumFrames == 0)
+			return statistics;
+
+		// Upper bound of the bucket the rank falls in, never more than the max
+		const auto getPercentile = [this](double percentile)
+		{
+			const uint64_t rank{ std::max(uint64_t(1), static_cast<uint64_t>(percentile * m_NumFrames + 0.999999)) };
+			uint64_t numBelow{ 0 };
+			for (uint32_t bucket{ 0 }; bucket < NumHistogramBuckets; ++bucket)
+			{
+				numBelow += m_HistogramBuckets[bucket];
+				if (numBelow >= rank)
+					return ToMilliseconds(std::min((bucket + 1) * HistogramBucketNs, m_MaxFrameNs));
+			}
+			return ToMilliseconds(m_MaxFrameNs);
+		};
+
+		statistics.p50Ms = getPercentile(0.50);
+		statistics.p95Ms = getPercentile(0.95);
+		statistics.p99Ms = getPercentile(0.99);
+		return statistics;
+	}
+
+	bool Timer::OpenTelemetry(const std::string& path)
+	{
+		CloseTelemetry();
+
+		m_TelemetryFile.open(path, std::ios::app);
+		if (!m_TelemetryFile)
+			return false;
+
+		const size_t extension = path.rfind('.');
+		m_IsTelemetryJson = extension != std::string::npos && (path.substr(extension) == ".json" || path.substr(extension) == ".jsonl");
+
+		m_TelemetryFile.seekp(0, std::ios::end);
+		if (!m_IsTelemetryJson && m_TelemetryFile.tellp() == std::streampos(0))
+			m_TelemetryFile << "time_s,frames,fps,p50_ms,p95_ms,p99_ms,max_ms\n";
+		return true;
+	}
+
+	void Timer::CloseTelemetry()
+	{
+		if (m_TelemetryFile.is_open())
+			m_TelemetryFile.close();
+	}
+
+	void Timer::RecordFrame(uint64_t elapsedNs)
+	{
+		m_RecentFrames[m_NumFrames % NumRecentFrames] = elapsedNs;
+		++m_NumFrames;
+
+		++m_HistogramBuckets[std::min(elapsedNs / HistogramBucketNs, uint64_t(NumHistogramBuckets - 1))];
+		m_MaxFrameNs = std::max(m_MaxFrameNs, elapsedNs);
+	}
+
+	void Timer::UpdateRollingFrameTimes(uint32_t numFrames)
+	{
+		// Once a second, so sorting a copy is cheap enough
+		const uint32_t count{ static_cast<uint32_t>(std::min({ uint64_t(numFrames), uint64_t(NumRecentFrames), m_NumFrames })) };
+		if (count == 0)
+			return;
+
+		uint64_t sortedFrames[NumRecentFrames];
+		for (uint32_t i{ 0 }; i < count; ++i)
+			sortedFrames[i] = m_RecentFrames[(m_NumFrames - 1 - i) % NumRecentFrames];
+		std::sort(sortedFrames, sortedFrames + count);
+
+		m_RollingFrameTimes.numFrames = count;
+		m_RollingFrameTimes.p50Ms = ToMilliseconds(GetPercentile(sortedFrames, count, 0.50));
+		m_RollingFrameTimes.p95Ms = ToMilliseconds(GetPercentile(sortedFrames, count, 0.95));
+		m_RollingFrameTimes.p99Ms = ToMilliseconds(GetPercentile(sortedFrames, count, 0.99));
+		m_RollingFrameTimes.maxMs = ToMilliseconds(sortedFrames[count - 1]);
+	}
+
+	void Timer::WriteTelemetry()
+	{
+		if (!m_TelemetryFile.is_open())
+			return;
+
+		const FrameTimeStatistics& frameTimes = m_RollingFrameTimes;
+		const char* pFormat = m_IsTelemetryJson ?
+			"{\"time_s\":%.3f,\"frames\":%llu,\"fps\":%.2f,\"p50_ms\":%.3f,\"p95_ms\":%.3f,\"p99_ms\":%.3f,\"max_ms\":%.3f}\n" :
+			"%.3f,%llu,%.2f,%.3f,%.3f,%.3f,%.3f\n";
+		const double totalTime = static_cast<double>(m_CurrentTime - m_PausedTime - m_BaseTime) * SecondsPerCount;
+		char line[256];
+		std::snprintf(line, sizeof(line), pFormat, totalTime, static_cast<unsigned long long>(frameTimes.numFrames), m_dFPS,
+			frameTimes.p50Ms, frameTimes.p95Ms, frameTimes.p99Ms, frameTimes.maxMs);
+
+		// One line a second, flushed so it can be followed live
+		m_TelemetryFile << line << std::flush;
+	}
+}
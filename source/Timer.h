@@ -2,14 +2,32 @@
 
 //Standard includes
 #include <cstdint>
+#include <fstream>
+#include <string>
 
 namespace dae
 {
+	// Frame time percentiles, nearest rank
+	struct FrameTimeStatistics
+	{
+		uint64_t numFrames{};
+		float p50Ms{};
+		float p95Ms{};
+		float p99Ms{};
+		float maxMs{};
+	};
+
 	class Timer
 	{
 	public:
-		Timer();
-		virtual ~Timer() = default;
+		// Frames the rolling window can hold, at a higher frame rate only the last ones of the second count
+		static constexpr uint32_t NumRecentFrames{ 4096 };
+		// Histogram of every frame since Reset: 0.1 ms buckets, the last one holds everything from 200 ms on
+		static constexpr uint32_t NumHistogramBuckets{ 2000 };
+		static constexpr uint64_t HistogramBucketNs{ 100'000 };
+
+		Timer() = default;
+		virtual ~Timer();
 
 		Timer(const Timer&) = delete;
 		Timer(Timer&&) noexcept = delete;
@@ -27,6 +45,16 @@ namespace dae
 		float GetTotal() const { return m_TotalTime; };
 		bool IsRunning() const { return !m_IsStopped; };
 
+		// Exact, of the frames in the last second (updated together with the FPS)
+		const FrameTimeStatistics& GetRollingFrameTimes() const { return m_RollingFrameTimes; };
+		// Since Reset, from the histogram (to 0.1 ms, max is exact)
+		FrameTimeStatistics GetTotalFrameTimes() const;
+
+		// Appends the rolling frame times of every second to path: JSON lines for .json / .jsonl, CSV otherwise (header when the file is new)
+		// The file is only written once a second, buffered. false when it can't be opened
+		bool OpenTelemetry(const std::string& path);
+		void CloseTelemetry();
+
 	private:
 		uint64_t m_BaseTime = 0;
 		uint64_t m_PausedTime = 0;
@@ -38,13 +66,27 @@ namespace dae
 		float m_dFPS = 0.0f;
 		uint32_t m_FPSCount = 0;
 
+		// Counts are nanoseconds, only the per frame values get narrowed to float
 		float m_TotalTime = 0.0f;
 		float m_ElapsedTime = 0.0f;
-		float m_SecondsPerCount = 0.0f;
 		float m_ElapsedUpperBound = 0.03f;
 		float m_FPSTimer = 0.0f;
 
 		bool m_IsStopped = true;
 		bool m_ForceElapsedUpperBound = false;
+
+		// Frame time recording, fixed size so Update never allocates
+		uint64_t m_RecentFrames[NumRecentFrames]{};  // Ring, ns
+		uint64_t m_NumFrames = 0;  // Recorded since Reset
+		uint32_t m_HistogramBuckets[NumHistogramBuckets]{};
+		uint64_t m_MaxFrameNs = 0;
+		FrameTimeStatistics m_RollingFrameTimes{};
+
+		std::ofstream m_TelemetryFile{};
+		bool m_IsTelemetryJson = false;
+
+		void RecordFrame(uint64_t elapsedNs);
+		void UpdateRollingFrameTimes(uint32_t numFrames);
+		void WriteTelemetry();
 	};
-}
\ No newline at end of file
+}
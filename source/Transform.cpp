@@ -0,0 +1,90 @@
+#include "Transform.h"
+
+Transform::Transform(const Vector3& position, const Quaternion& rotation, const Vector3& scale) :
+	m_Position{ position },
+	m_Rotation{ rotation },
+	m_Scale{ scale }
+{
+	SetDirty();
+}
+
+void Transform::SetPosition(const Vector3& position)
+{
+	m_Position = position;
+	SetDirty();
+}
+
+void Transform::Translate(const Vector3& translation)
+{
+	m_Position += translation;
+	SetDirty();
+}
+
+void Transform::SetRotation(const Quaternion& rotation)
+{
+	m_Rotation = rotation.Normalized();
+	SetDirty();
+}
+
+void Transform::Rotate(const Quaternion& rotation)
+{
+	// Renormalize every time so the small per frame rotations dont drift into a scaling rotation
+	m_Rotation = (m_Rotation * rotation).Normalized();
+	SetDirty();
+}
+
+void Transform::SetScale(const Vector3& scale)
+{
+	m_Scale = scale;
+	SetDirty();
+}
+
+void Transform::Scale(const Vector3& scale)
+{
+	m_Scale = { m_Scale.x * scale.x, m_Scale.y * scale.y, m_Scale.z * scale.z };
+	SetDirty();
+}
+
+const Matrix& Transform::GetWorldMatrix() const
+{
+	if(m_IsWorldMatrixDirty)
+	{
+		// Scale * Rotation * Translation without the 2 matrix multiplies: scale the rotated axes, put the position in the last row
+		const Matrix rotation{ m_Rotation.ToMatrix() };
+		m_WorldMatrix = Matrix{
+			rotation.GetAxisX() * m_Scale.x,
+			rotation.GetAxisY() * m_Scale.y,
+			rotation.GetAxisZ() * m_Scale.z,
+			m_Position
+		};
+
+		m_IsWorldMatrixDirty = false;
+	}
+
+	return m_WorldMatrix;
+}
+
+const Matrix& Transform::GetNormalMatrix() const
+{
+	if(m_IsNormalMatrixDirty)
+	{
+		// Inverse of scale is 1 / scale, inverse of rotation is its transpose, transposing both again leaves the rotation with inverted scale
+		const Matrix rotation{ m_Rotation.ToMatrix() };
+		m_NormalMatrix = Matrix{
+			rotation.GetAxisX() / m_Scale.x,
+			rotation.GetAxisY() / m_Scale.y,
+			rotation.GetAxisZ() / m_Scale.z,
+			Vector3::Zero
+		};
+
+		m_IsNormalMatrixDirty = false;
+	}
+
+	return m_NormalMatrix;
+}
+
+void Transform::SetDirty()
+{
+	m_IsWorldMatrixDirty = true;
+	m_IsNormalMatrixDirty = true;
+}
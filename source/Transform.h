@@ -0,0 +1,45 @@
+#pragma once
+#include "Math.h"
+#include "Quaternion.h"
+
+using namespace dae;
+
+// Position, rotation and scale of an object, the world and normal matrix are only rebuilt after one of them changed
+// The getters rebuild lazily, call them once before handing the matrices to worker threads
+class Transform final
+{
+public:
+	Transform() = default;
+	Transform(const Vector3& position, const Quaternion& rotation = Quaternion::Identity, const Vector3& scale = { 1.f, 1.f, 1.f });
+
+	void SetPosition(const Vector3& position);
+	void Translate(const Vector3& translation);
+
+	void SetRotation(const Quaternion& rotation);
+	void Rotate(const Quaternion& rotation);
+
+	void SetScale(const Vector3& scale);
+	void Scale(const Vector3& scale);
+
+	const Vector3& GetPosition() const { return m_Position; };
+	const Quaternion& GetRotation() const { return m_Rotation; };
+	const Vector3& GetScale() const { return m_Scale; };
+
+	// Scale * Rotation * Translation
+	const Matrix& GetWorldMatrix() const;
+
+	// Inverse transpose of the world matrix, keeps normals perpendicular under non-uniform scale (no translation)
+	const Matrix& GetNormalMatrix() const;
+
+private:
+	Vector3 m_Position{};
+	Quaternion m_Rotation{};
+	Vector3 m_Scale{ 1.f, 1.f, 1.f };
+
+	mutable Matrix m_WorldMatrix{};
+	mutable Matrix m_NormalMatrix{};
+	mutable bool m_IsWorldMatrixDirty{ false };
+	mutable bool m_IsNormalMatrixDirty{ false };
+
+	void SetDirty();
+};
@@ -0,0 +1,89 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+
+// Hands the newest of a stream of values from one thread to another, neither side ever waits on the work of the other
+// The writer fills GetWriteBuffer and publishes it, the reader acquires the latest published one and keeps it until it acquires again.
+// A published value the reader never got to is simply overwritten by the next one.
+template<typename T>
+class TripleBuffer final
+{
+public:
+	TripleBuffer() = default;
+
+	~TripleBuffer() = default;
+	TripleBuffer(const TripleBuffer&) = delete;
+	TripleBuffer& operator=(const TripleBuffer&) = delete;
+	TripleBuffer(TripleBuffer&&) = delete;
+	TripleBuffer& operator=(TripleBuffer&&) = delete;
+
+	// Writer thread only
+	T& GetWriteBuffer() { return m_Buffers[m_WriteIndex]; };
+	void Publish()
+	{
+		{
+			std::lock_guard<std::mutex> lock{ m_Mutex };
+			std::swap(m_WriteIndex, m_LatestIndex);
+			m_HasNewBuffer = true;
+		}
+		m_Condition.notify_one();
+	}
+
+	// Reader thread only
+	T& GetReadBuffer() { return m_Buffers[m_ReadIndex]; };
+
+	// Swaps in the latest published value, returns false (and keeps the current one) when nothing new was published
+	bool Acquire()
+	{
+		std::lock_guard<std::mutex> lock{ m_Mutex };
+		return AcquireLocked();
+	}
+
+	// Sleeps until something new is published and acquires it, returns false once keepWaiting turned false (see WakeReader)
+	bool WaitAndAcquire(const std::atomic<bool>& keepWaiting)
+	{
+		std::unique_lock<std::mutex> lock{ m_Mutex };
+		m_Condition.wait(lock, [&]() { return m_HasNewBuffer || !keepWaiting; });
+		if(!keepWaiting)
+			return false;
+
+		return AcquireLocked();
+	}
+
+	// Call after turning the keepWaiting flag of WaitAndAcquire off
+	void WakeReader()
+	{
+		{
+			std::lock_guard<std::mutex> lock{ m_Mutex };
+		}
+		m_Condition.notify_all();
+	}
+
+	// Access to all 3, only while neither thread uses them (setup, shutdown)
+	T& operator[](uint32_t index) { return m_Buffers[index]; };
+	static constexpr uint32_t Size() { return 3; };
+
+private:
+	T m_Buffers[3]{};
+	uint32_t m_WriteIndex{ 0 };
+	uint32_t m_ReadIndex{ 1 };
+	uint32_t m_LatestIndex{ 2 };
+	bool m_HasNewBuffer{ false };
+
+	// Guards m_LatestIndex and m_HasNewBuffer, the other 2 indices belong to their own thread
+	std::mutex m_Mutex{};
+	std::condition_variable m_Condition{};
+
+	bool AcquireLocked()
+	{
+		if(!m_HasNewBuffer)
+			return false;
+
+		std::swap(m_ReadIndex, m_LatestIndex);
+		m_HasNewBuffer = false;
+		return true;
+	}
+};
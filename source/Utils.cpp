@@ -1,13 +1,28 @@
-#include "pch.h"
 #include "Utils.h"
 
+#include <iostream>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#endif
+
 // Made the CPP file because of linker errors when i had it defined in the header file.
 
 void Utils::PrintColor(const std::string& text, TextColor textColor, const std::string& end)
 {
+#if defined(_WIN32)
 	HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
 
 	SetConsoleTextAttribute(hConsole, static_cast<WORD>(textColor));
 	std::cout << text << end;
 	SetConsoleTextAttribute(hConsole, static_cast<WORD>(TextColor::White));  // Default color
+#else
+	// Same bits as the windows console attribute, ANSI has red and blue swapped and the intensity as its own range
+	const int color{ static_cast<int>(textColor) };
+	const int ansiColor{ ((color & 4) >> 2) | (color & 2) | ((color & 1) << 2) };
+	const int ansiCode{ (color & 8 ? 90 : 30) + ansiColor };
+
+	std::cout << "\033[" << ansiCode << "m" << text << "\033[0m" << end;
+#endif
 }
@@ -1,5 +1,7 @@
 #pragma once
 #include <fstream>
+#include <string>
+#include <vector>
 #include "Math.h"
 #include "Mesh.h"
 
@@ -37,8 +39,10 @@ namespace Utils
 	};
 
 	//Just parses vertices and indices
+#if defined(_MSC_VER)
 #pragma warning(push)
 #pragma warning(disable : 4505) //Warning unreferenced local function
+#endif
 	static bool ParseOBJ(const std::string& filename, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, bool flipAxisAndWinding = true)
 	{
 		std::ifstream file(filename);
@@ -188,7 +192,9 @@ namespace Utils
 
 		return true;
 	}
-#pragma warning(pop)	
+#if defined(_MSC_VER)
+#pragma warning(pop)
+#endif
 
 	void PrintColor(const std::string& text, TextColor textColor, const std::string& end = "\n");
 
@@ -0,0 +1,57 @@
+#pragma once
+#include "Floatx4.h"
+#include "Vector2.h"
+
+namespace dae
+{
+	// 4 Vector2's in SoA layout, one per lane
+	struct Vector2x4
+	{
+		Floatx4 x{};
+		Floatx4 y{};
+
+		Vector2x4() = default;
+		Vector2x4(const Floatx4& _x, const Floatx4& _y) : x{ _x }, y{ _y } {}
+		explicit Vector2x4(const Vector2& v) : x{ v.x }, y{ v.y } {}
+
+		Vector2 GetLane(int lane) const
+		{
+			float xLanes[4], yLanes[4];
+			x.Store(xLanes);
+			y.Store(yLanes);
+			return { xLanes[lane], yLanes[lane] };
+		}
+
+		static Floatx4 Dot(const Vector2x4& v1, const Vector2x4& v2)
+		{
+			return v1.x * v2.x + v1.y * v2.y;
+		}
+
+		static Floatx4 Cross(const Vector2x4& v1, const Vector2x4& v2)
+		{
+			return v1.x * v2.y - v1.y * v2.x;
+		}
+
+		//Member Operators
+		Vector2x4 operator*(const Floatx4& scale) const { return { x * scale, y * scale }; }
+		Vector2x4 operator/(const Floatx4& scale) const { return { x / scale, y / scale }; }
+		Vector2x4 operator+(const Vector2x4& v) const { return { x + v.x, y + v.y }; }
+		Vector2x4 operator-(const Vector2x4& v) const { return { x - v.x, y - v.y }; }
+		Vector2x4 operator-() const { return { -x, -y }; }
+		Vector2x4& operator+=(const Vector2x4& v) { x += v.x; y += v.y; return *this; }
+		Vector2x4& operator-=(const Vector2x4& v) { x -= v.x; y -= v.y; return *this; }
+		Vector2x4& operator*=(const Floatx4& scale) { x *= scale; y *= scale; return *this; }
+		Vector2x4& operator/=(const Floatx4& scale) { x /= scale; y /= scale; return *this; }
+	};
+
+	//Global Operators
+	inline Vector2x4 operator*(const Vector2& v, const Floatx4& scale)
+	{
+		return { scale * v.x, scale * v.y };
+	}
+
+	inline Vector2x4 Select(const Floatx4& mask, const Vector2x4& a, const Vector2x4& b)
+	{
+		return { Select(mask, a.x, b.x), Select(mask, a.y, b.y) };
+	}
+}
@@ -0,0 +1,94 @@
+#pragma once
+#include "Floatx4.h"
+#include "Vector3.h"
+
+namespace dae
+{
+	// 4 Vector3's in SoA layout, one per lane
+	struct Vector3x4
+	{
+		Floatx4 x{};
+		Floatx4 y{};
+		Floatx4 z{};
+
+		Vector3x4() = default;
+		Vector3x4(const Floatx4& _x, const Floatx4& _y, const Floatx4& _z) : x{ _x }, y{ _y }, z{ _z } {}
+		explicit Vector3x4(const Vector3& v) : x{ v.x }, y{ v.y }, z{ v.z } {}
+
+		Vector3 GetLane(int lane) const
+		{
+			float xLanes[4], yLanes[4], zLanes[4];
+			x.Store(xLanes);
+			y.Store(yLanes);
+			z.Store(zLanes);
+			return { xLanes[lane], yLanes[lane], zLanes[lane] };
+		}
+
+		Floatx4 Magnitude() const
+		{
+			return Sqrt(SqrMagnitude());
+		}
+
+		Floatx4 SqrMagnitude() const
+		{
+			return x * x + y * y + z * z;
+		}
+
+		Floatx4 Normalize()
+		{
+			const Floatx4 m{ Magnitude() };
+			x /= m;
+			y /= m;
+			z /= m;
+
+			return m;
+		}
+
+		Vector3x4 Normalized() const
+		{
+			const Floatx4 m{ Magnitude() };
+			return { x / m, y / m, z / m };
+		}
+
+		static Floatx4 Dot(const Vector3x4& v1, const Vector3x4& v2)
+		{
+			return v1.x * v2.x + v1.y * v2.y + v1.z * v2.z;
+		}
+
+		static Vector3x4 Cross(const Vector3x4& v1, const Vector3x4& v2)
+		{
+			return Vector3x4{
+				v1.y * v2.z - v1.z * v2.y,
+				v1.z * v2.x - v1.x * v2.z,
+				v1.x * v2.y - v1.y * v2.x
+			};
+		}
+
+		static Vector3x4 Reflect(const Vector3x4& v1, const Vector3x4& v2)
+		{
+			return v1 - (v2 * (2.0f * Dot(v1, v2)));
+		}
+
+		//Member Operators
+		Vector3x4 operator*(const Floatx4& scale) const { return { x * scale, y * scale, z * scale }; }
+		Vector3x4 operator/(const Floatx4& scale) const { return { x / scale, y / scale, z / scale }; }
+		Vector3x4 operator+(const Vector3x4& v) const { return { x + v.x, y + v.y, z + v.z }; }
+		Vector3x4 operator-(const Vector3x4& v) const { return { x - v.x, y - v.y, z - v.z }; }
+		Vector3x4 operator-() const { return { -x, -y, -z }; }
+		Vector3x4& operator+=(const Vector3x4& v) { x += v.x; y += v.y; z += v.z; return *this; }
+		Vector3x4& operator-=(const Vector3x4& v) { x -= v.x; y -= v.y; z -= v.z; return *this; }
+		Vector3x4& operator*=(const Floatx4& scale) { x *= scale; y *= scale; z *= scale; return *this; }
+		Vector3x4& operator/=(const Floatx4& scale) { x /= scale; y /= scale; z /= scale; return *this; }
+	};
+
+	//Global Operators
+	inline Vector3x4 operator*(const Vector3& v, const Floatx4& scale)
+	{
+		return { scale * v.x, scale * v.y, scale * v.z };
+	}
+
+	inline Vector3x4 Select(const Floatx4& mask, const Vector3x4& a, const Vector3x4& b)
+	{
+		return { Select(mask, a.x, b.x), Select(mask, a.y, b.y), Select(mask, a.z, b.z) };
+	}
+}
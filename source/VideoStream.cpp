@@ -0,0 +1,176 @@
+#include "VideoStream.h"
+
+#include <csignal>
+#include <iostream>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace
+{
+	// The original stdout for the stream, messages go to stderr from now on
+	std::FILE* TakeStdout()
+	{
+		std::cout.flush();
+		std::fflush(stdout);
+
+#ifdef _WIN32
+		const int streamFile{ _dup(_fileno(stdout)) };
+		if(streamFile < 0)
+			return nullptr;
+		_setmode(streamFile, _O_BINARY);
+		_dup2(_fileno(stderr), _fileno(stdout));
+		return _fdopen(streamFile, "wb");
+#else
+		const int streamFile{ dup(fileno(stdout)) };
+		if(streamFile < 0)
+			return nullptr;
+		dup2(fileno(stderr), fileno(stdout));
+		return fdopen(streamFile, "wb");
+#endif
+	}
+}
+
+VideoStream* VideoStream::Open(const std::string& path, Format format, int width, int height, int framesPerSecond)
+{
+#ifndef _WIN32
+	// A consumer that quits should fail the writes, not end the process
+	std::signal(SIGPIPE, SIG_IGN);
+#endif
+
+	std::FILE* pFile{ path == "-" ? TakeStdout() : std::fopen(path.c_str(), "wb") };
+	if(!pFile)
+	{
+		std::cout << "VideoStream: could not open " << path << "\n";
+		return nullptr;
+	}
+
+	if(format == Format::Y4M)
+		std::fprintf(pFile, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", width, height, framesPerSecond);
+
+	return new VideoStream{ pFile, format, width, height };
+}
+
+VideoStream::VideoStream(std::FILE* pFile, Format format, int width, int height):
+	m_pFile{ pFile },
+	m_Format{ format },
+	m_Width{ width },
+	m_Height{ height }
+{
+	const size_t numPixels{ size_t(width) * height };
+	const int chromaWidth{ (width + 1) / 2 };
+	const size_t numChromaSamples{ size_t(chromaWidth) * ((height + 1) / 2) };
+
+	for(Frame& frame : m_Frames)
+	{
+		if(format == Format::Y4M)
+		{
+			// Planes back to back, the way a Y4M frame is laid out
+			frame.data.resize(numPixels + 2 * numChromaSamples);
+			frame.yuv.pY = frame.data.data();
+			frame.yuv.pU = frame.yuv.pY + numPixels;
+			frame.yuv.pV = frame.yuv.pU + numChromaSamples;
+			frame.yuv.yPitch = width;
+			frame.yuv.uvPitch = chromaWidth;
+		}
+		else
+		{
+			frame.data.resize(numPixels * sizeof(uint32_t));
+			frame.pPixels = reinterpret_cast<uint32_t*>(frame.data.data());
+		}
+		m_FreeFrames.push_back(&frame);
+	}
+
+	m_Thread = std::thread{ &VideoStream::WriteLoop, this };
+}
+
+VideoStream::~VideoStream()
+{
+	{
+		std::lock_guard<std::mutex> lock{ m_Mutex };
+		m_IsStopping = true;
+	}
+	m_Condition.notify_all();
+	m_Thread.join();
+
+	std::fclose(m_pFile);
+}
+
+VideoStream::Frame* VideoStream::AcquireFrame()
+{
+	std::unique_lock<std::mutex> lock{ m_Mutex };
+	m_Condition.wait(lock, [this]() { return !m_FreeFrames.empty(); });
+
+	Frame* pFrame{ m_FreeFrames.front() };
+	m_FreeFrames.pop_front();
+	return pFrame;
+}
+
+void VideoStream::ReleaseFrame(Frame* pFrame)
+{
+	{
+		std::lock_guard<std::mutex> lock{ m_Mutex };
+		m_FreeFrames.push_back(pFrame);
+	}
+	m_Condition.notify_all();
+}
+
+void VideoStream::Submit(Frame* pFrame)
+{
+	{
+		std::lock_guard<std::mutex> lock{ m_Mutex };
+		m_QueuedFrames.push_back(pFrame);
+	}
+	m_Condition.notify_all();
+}
+
+void VideoStream::Flush()
+{
+	std::unique_lock<std::mutex> lock{ m_Mutex };
+	m_Condition.wait(lock, [this]() { return m_FreeFrames.size() == NumFrames; });
+}
+
+bool VideoStream::HasFailed() const
+{
+	std::lock_guard<std::mutex> lock{ m_Mutex };
+	return m_HasFailed;
+}
+
+void VideoStream::WriteLoop()
+{
+	bool hasFailed{ false };
+	while(true)
+	{
+		Frame* pFrame{ nullptr };
+		{
+			std::unique_lock<std::mutex> lock{ m_Mutex };
+			m_Condition.wait(lock, [this]() { return m_IsStopping || !m_QueuedFrames.empty(); });
+			if(m_QueuedFrames.empty())
+				break;
+
+			pFrame = m_QueuedFrames.front();
+			m_QueuedFrames.pop_front();
+		}
+
+		if(!hasFailed)
+		{
+			if(m_Format == Format::Y4M)
+				std::fputs("FRAME\n", m_pFile);
+			hasFailed = std::fwrite(pFrame->data.data(), 1, pFrame->data.size(), m_pFile) != pFrame->data.size();
+
+			if(hasFailed)
+			{
+				std::lock_guard<std::mutex> lock{ m_Mutex };
+				m_HasFailed = true;
+			}
+		}
+
+		ReleaseFrame(pFrame);
+	}
+
+	std::fflush(m_pFile);
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include "SoftwareRasterizer.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Uncompressed video for an encoder that reads it live, from stdout or a named pipe
+//   Y4M:  YUV4MPEG2 header + YUV 4:2:0 frames (ffmpeg -i -, x264 --demuxer y4m -)
+//   RGBA: nothing but width x height x 4 bytes per frame, R G B A in memory order (ffmpeg -f rawvideo -pix_fmt rgba -s WxH -i -)
+// The frames get written on a thread of its own, in the order they were submitted, so the renderer only waits when the consumer can't keep up
+class VideoStream final
+{
+public:
+	enum class Format
+	{
+		Y4M,
+		RGBA,
+	};
+
+	// Buffer of one frame, render into yuv (Y4M) or pPixels (RGBA, pitch = width)
+	struct Frame
+	{
+		std::vector<uint8_t> data{};
+		YUVTarget yuv{};
+		uint32_t* pPixels{ nullptr };
+	};
+
+	// path "-" streams to stdout, everything else printed to stdout goes to stderr from then on
+	// A named pipe blocks here until its reader opens it. nullptr when it can't be opened
+	static VideoStream* Open(const std::string& path, Format format, int width, int height, int framesPerSecond);
+
+	~VideoStream();
+	VideoStream(const VideoStream&) = delete;
+	VideoStream& operator=(const VideoStream&) = delete;
+	VideoStream(VideoStream&&) = delete;
+	VideoStream& operator=(VideoStream&&) = delete;
+
+	// Waits until the writer gave a buffer back
+	Frame* AcquireFrame();
+	// Gives a buffer back without writing it (nothing was rendered into it)
+	void ReleaseFrame(Frame* pFrame);
+	// Writes the frame after the ones submitted before it
+	void Submit(Frame* pFrame);
+	// Waits until every submitted frame is written
+	void Flush();
+
+	Format GetFormat() const { return m_Format; };
+	// The consumer went away (or the disk is full), later frames are dropped
+	bool HasFailed() const;
+
+private:
+	static constexpr int NumFrames{ 3 };  // One rendering, one writing, one spare
+
+	VideoStream(std::FILE* pFile, Format format, int width, int height);
+
+	std::FILE* m_pFile{ nullptr };
+	Format m_Format{};
+	int m_Width{};
+	int m_Height{};
+
+	Frame m_Frames[NumFrames]{};
+	std::deque<Frame*> m_FreeFrames{};
+	std::deque<Frame*> m_QueuedFrames{};
+
+	std::thread m_Thread{};
+	mutable std::mutex m_Mutex{};
+	std::condition_variable m_Condition{};
+	bool m_IsStopping{ false };
+	bool m_HasFailed{ false };
+
+	void WriteLoop();
+};
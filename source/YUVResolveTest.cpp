@@ -0,0 +1,104 @@
+#include "JobSystem.h"
+#include "Mesh.h"
+#include "SoftwareRasterizer.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace dae;
+
+// YUV resolve of a frame with an odd width and height: the edge chroma samples only average the pixels that exist
+// Every chroma sample gets compared against a BT.601 conversion of the 2x2 block of the packed output
+// Returns 0 when every sample matches
+
+namespace
+{
+	constexpr int Width{ 333 };
+	constexpr int Height{ 201 };
+
+	struct Block
+	{
+		float red{};
+		float green{};
+		float blue{};
+	};
+
+	// Average of the pixels of the 2x2 block that are inside the frame
+	Block AverageBlock(const std::vector<uint32_t>& pixels, const PixelPacking& pixelPacking, int chromaX, int chromaY)
+	{
+		Block block{};
+		for(int row{ 0 }; row < 2; ++row)
+		{
+			for(int column{ 0 }; column < 2; ++column)
+			{
+				const int x{ std::min(chromaX * 2 + column, Width - 1) };
+				const int y{ std::min(chromaY * 2 + row, Height - 1) };
+				const uint32_t pixel{ pixels[size_t(y) * Width + x] };
+				block.red += float((pixel >> pixelPacking.redShift) & 0xff) * 0.25f;
+				block.green += float((pixel >> pixelPacking.greenShift) & 0xff) * 0.25f;
+				block.blue += float((pixel >> pixelPacking.blueShift) & 0xff) * 0.25f;
+			}
+		}
+		return block;
+	}
+}
+
+int main()
+{
+	JobSystem jobSystem{};
+	SoftwareRasterizer rasterizer{ Width, Height, jobSystem };
+
+	// One triangle over the whole screen, its bounding box is white everywhere
+	// The clear color only stays in the tile padding right of the frame, a resolve that reads it shows up as a red fringe
+	const std::vector<Vertex> vertices{
+		Vertex{ { -1.0f, -1.0f, 0.5f } },
+		Vertex{ { 1.0f, -1.0f, 0.5f } },
+		Vertex{ { 1.0f, 1.0f, 0.5f } }
+	};
+	const Mesh mesh{ vertices, { 0, 1, 2 } };
+
+	SoftwareScene scene{};
+	scene.meshes.push_back(SoftwareMeshInstance{ &mesh });
+
+	SoftwareRenderSettings settings{};
+	settings.ShowBoundingBox = true;
+	settings.CullMode = SoftwareRenderSettings::CullModes::None;
+	settings.ClearColor = ColorRGB{ 1.0f, 0.0f, 0.0f };
+
+	const int chromaWidth{ (Width + 1) / 2 };
+	const int chromaHeight{ (Height + 1) / 2 };
+	std::vector<uint32_t> pixels(size_t(Width) * Height);
+	std::vector<uint8_t> lumaPlane(size_t(Width) * Height);
+	std::vector<uint8_t> uPlane(size_t(chromaWidth) * chromaHeight);
+	std::vector<uint8_t> vPlane(size_t(chromaWidth) * chromaHeight);
+	const YUVTarget yuvTarget{ lumaPlane.data(), uPlane.data(), vPlane.data(), Width, chromaWidth };
+	rasterizer.Render(scene, settings, pixels.data(), Width, &yuvTarget);
+
+	// Same coefficients as the resolve, off by one is rounding
+	int numMismatches{ 0 };
+	for(int chromaY{ 0 }; chromaY < chromaHeight; ++chromaY)
+	{
+		for(int chromaX{ 0 }; chromaX < chromaWidth; ++chromaX)
+		{
+			const Block block{ AverageBlock(pixels, rasterizer.GetPixelPacking(), chromaX, chromaY) };
+			const int u{ int(128.5f - 0.148223f * block.red - 0.290993f * block.green + 0.439216f * block.blue) };
+			const int v{ int(128.5f + 0.439216f * block.red - 0.367788f * block.green - 0.071427f * block.blue) };
+
+			const size_t index{ size_t(chromaY) * chromaWidth + chromaX };
+			if(std::abs(uPlane[index] - u) > 1 || std::abs(vPlane[index] - v) > 1)
+			{
+				if(numMismatches < 8)
+				{
+					std::cout << "YUVResolveTest: chroma " << chromaX << ", " << chromaY << " is " << int(uPlane[index]) << ", " << int(vPlane[index])
+						<< " instead of " << u << ", " << v << "\n";
+				}
+				++numMismatches;
+			}
+		}
+	}
+
+	std::cout << "YUVResolveTest: " << Width << "x" << Height << (numMismatches == 0 ? " passed\n" : " FAILED\n");
+	return numMismatches == 0 ? 0 : 1;
+}
@@ -6,6 +6,10 @@
 
 #undef main
 #include "Renderer.h"
+#include "Profiler.h"
+
+#include <chrono>
+#include <thread>
 
 using namespace dae;
 
@@ -27,11 +31,49 @@ void TogglePrintFPS()
 		Utils::PrintColor("**(SHARED) Print FPS OFF", Utils::TextColor::Green);
 }
 
+void WriteTrace()
+{
+	// Without DAE_PROFILING nothing gets recorded
+	if(!Profiler::IsEnabled())
+		return;
+
+	if(Profiler::WriteChromeTrace("trace.json"))
+		Utils::PrintColor("**(SHARED) Trace written to trace.json", Utils::TextColor::Green);
+	else
+		Utils::PrintColor("**(SHARED) Could not write trace.json", Utils::TextColor::Green);
+}
+
 int main(int argc, char* args[])
 {
-	//Unreferenced parameters
-	(void)argc;
-	(void)args;
+	// Optional software rasterizer thread setup: -workers <count>, -pin (pin workers to cores), -reservemain (keep core 0 for this thread)
+	// -renderthread: render on a thread of its own, input + update run on this thread at a fixed rate (-updaterate <hz>, default 60)
+	// -asyncpresent: blit + show the software frames on a thread of their own
+	// -frametimes <file>: append the frame time percentiles of every second, .json / .jsonl as JSON lines, CSV otherwise (of the rendered frames, also with -renderthread)
+	JobSystemSettings jobSystemSettings{};
+	std::string frameTimesPath{};
+	bool useRenderThread{ false };
+	bool useAsyncPresent{ false };
+	float updateRate{ 60.0f };
+	for(int i{ 1 }; i < argc; ++i)
+	{
+		const std::string argument{ args[i] };
+		if(argument == "-workers" && i + 1 < argc)
+			jobSystemSettings.NumWorkers = std::atoi(args[++i]);
+		else if(argument == "-pin")
+			jobSystemSettings.PinWorkers = true;
+		else if(argument == "-reservemain")
+			jobSystemSettings.ReserveMainCore = true;
+		else if(argument == "-renderthread")
+			useRenderThread = true;
+		else if(argument == "-asyncpresent")
+			useAsyncPresent = true;
+		else if(argument == "-updaterate" && i + 1 < argc)
+			updateRate = std::max(1.0f, float(std::atof(args[++i])));
+		else if(argument == "-frametimes" && i + 1 < argc)
+			frameTimesPath = args[++i];
+	}
+
+	DAE_PROFILE_THREAD("Main");
 
 	//Create window + surfaces
 	SDL_Init(SDL_INIT_VIDEO);
@@ -50,7 +92,25 @@ int main(int argc, char* args[])
 
 	//Initialize "framework"
 	const auto pTimer = new Timer();
-	const auto pRenderer = new Renderer(pWindow);
+	const auto pRenderer = new Renderer(pWindow, jobSystemSettings);
+
+	// With the render thread this loop runs at the update rate, the frame times come from the render thread then
+	if(!frameTimesPath.empty())
+	{
+		const bool isOpen{ useRenderThread ? pRenderer->OpenRenderThreadTelemetry(frameTimesPath) : pTimer->OpenTelemetry(frameTimesPath) };
+		if(!isOpen)
+			std::cout << "Could not open " << frameTimesPath << std::endl;
+	}
+
+	if(useAsyncPresent)
+		pRenderer->StartPresentThread();
+	if(useRenderThread)
+		pRenderer->StartRenderThread();
+
+	// Fixed update rate when the renderer has its own thread, a slow frame no longer holds up the input
+	const std::chrono::steady_clock::duration updatePeriod{ std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(1.0f / updateRate)) };
+	std::chrono::steady_clock::time_point nextUpdateTime{ std::chrono::steady_clock::now() };
+	uint32_t lastRenderedFrames{ 0 };
 
 	//Start loop
 	pTimer->Start();
@@ -97,6 +157,10 @@ int main(int argc, char* args[])
 							TogglePrintFPS();
 							break;
 
+						case SDL_SCANCODE_T:
+							WriteTrace();
+							break;
+
 							// Hardware rasterizer only ----------------------------------------
 						case SDL_SCANCODE_F3:
 							pRenderer->ToggleFireFX();
@@ -119,6 +183,12 @@ int main(int argc, char* args[])
 						case SDL_SCANCODE_F8:
 							pRenderer->ToggleBoundingBox();
 							break;
+						case SDL_SCANCODE_P:
+							pRenderer->TogglePipelinedFrames();
+							break;
+						case SDL_SCANCODE_G:
+							pRenderer->ToggleSRGBOutput();
+							break;
 
 							// Debug helper
 						case SDL_SCANCODE_ESCAPE:
@@ -133,7 +203,16 @@ int main(int argc, char* args[])
 		pRenderer->Update(pTimer);
 
 		//--------- Render ---------
-		pRenderer->Render();
+		if(pRenderer->IsRenderThreadRunning())
+		{
+			// The render thread picks up the snapshot Update just published, wait for the next update tick (no catching up when we fell behind)
+			nextUpdateTime = std::max(nextUpdateTime + updatePeriod, std::chrono::steady_clock::now());
+			std::this_thread::sleep_until(nextUpdateTime);
+		}
+		else
+		{
+			pRenderer->Render();
+		}
 
 		//--------- Timer ---------
 		pTimer->Update();
@@ -141,11 +220,25 @@ int main(int argc, char* args[])
 		if(printTimer >= 1.f)
 		{
 			printTimer = 0.f;
-			if(gPrintFPS)
-				std::cout << "dFPS: " << pTimer->GetdFPS() << std::endl;
+			if(gPrintFPS && pRenderer->IsRenderThreadRunning())
+			{
+				// The loop here runs at the update rate, the frames are counted on the render thread
+				const uint32_t renderedFrames{ pRenderer->GetNumRenderedFrames() };
+				std::cout << "dFPS: " << renderedFrames - lastRenderedFrames << " (updates: " << pTimer->GetdFPS() << ")" << std::endl;
+				lastRenderedFrames = renderedFrames;
+			}
+			else if(gPrintFPS)
+			{
+				// SLOs are on the tail, the average hides the hitches
+				const FrameTimeStatistics& frameTimes{ pTimer->GetRollingFrameTimes() };
+				std::cout << "dFPS: " << pTimer->GetdFPS() << " (frame ms p50: " << frameTimes.p50Ms << ", p95: " << frameTimes.p95Ms
+					<< ", p99: " << frameTimes.p99Ms << ", max: " << frameTimes.maxMs << ")" << std::endl;
+			}
 		}
 	}
 	pTimer->Stop();
+	pRenderer->StopRenderThread();
+	pRenderer->StopPresentThread();
 
 	//Shutdown "framework"
 	delete pRenderer;